@@ -1,14 +1,39 @@
 #version 330 core
 
 in vec2 v_TexCoords;
+flat in vec4 v_Wedge;
+flat in float v_IsWedge;
 layout(location = 0) out vec4 final;
 
 uniform vec2 u_MouseCoords;
 uniform vec2 u_Resolution;
 uniform vec2 u_Offset;
 uniform vec3 u_LightColor;
+uniform float u_Intensity;
+uniform float u_LightSize;
 uniform sampler2D u_Texture;
 
+const float PI = 3.14159265358979;
+
+float cross2(vec2 a, vec2 b) {
+	return a.x * b.y - a.y * b.x;
+}
+
+// The fraction of the light disk visible from this fragment past the wall at a penumbra wedge's vertex.
+//   Light on the wall's side of the line through the fragment and the vertex is blocked, so the visible part
+//   is the disk cut by that line, whose area follows from the light's signed distance to it. Overlapping wedges
+//   are combined by min and max blending rather than here.
+float coverage() {
+	if (v_IsWedge < 0.5) {
+		return 1.0;
+	}
+
+	vec2 toApex = normalize(v_Wedge.xy - gl_FragCoord.xy);
+	float wallSide = sign(cross2(toApex, v_Wedge.zw));
+	float x = clamp(-wallSide * cross2(toApex, u_MouseCoords - gl_FragCoord.xy) / u_LightSize, -1.0, 1.0);
+	return 1.0 - (acos(x) - x * sqrt(1.0 - x * x)) / PI;
+}
+
 void main() {
 	vec3 ambientColor = vec3(1.0, 1.0, 1.0);
 	vec3 floorColor = texture(u_Texture, v_TexCoords).rgb;
@@ -28,12 +53,12 @@ void main() {
 
 
 	float diff = max(dot(lightNormal, lightDir), 0.0);
-	vec3 diffuse = diff * u_LightColor;
+	vec3 diffuse = diff * coverage() * u_LightColor;
 
 	vec3 phongLight = (ambient + attenuation * diffuse) * floorColor;
 
     // Reinhard tone mapping
     vec3 ldr = phongLight / (phongLight + vec3(1.0));
 
-	final = vec4(pow(ldr, gamma), 1.0);
+	final = vec4(pow(ldr, gamma), u_Intensity);
 }
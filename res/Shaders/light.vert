@@ -1,7 +1,15 @@
 #version 330 core
 
 layout(location = 0) in vec4 position;
+
+// Penumbra wedges only: the silhouette vertex and the direction its wall leaves in, and 1 to mark a wedge.
+//   A disabled attribute reads as (0, 0, 0, 1), so isWedge is 0 for a plain light fan.
+layout(location = 1) in vec4 wedge;
+layout(location = 2) in float isWedge;
+
 out vec2 v_TexCoords;
+flat out vec4 v_Wedge;
+flat out float v_IsWedge;
 
 uniform vec2 u_Offset;
 uniform vec2 u_Resolution;
@@ -11,5 +19,7 @@ void main() {
 	// Given that all points on this shape fall within the quad defining the floor,
 	// the texture coordinates can be mapped directly to the normalized vertex positions.
 	v_TexCoords = (position.xy - u_Offset) / u_Resolution;
+	v_Wedge = wedge;
+	v_IsWedge = isWedge;
 	gl_Position = u_Projection * position;
 }
\ No newline at end of file
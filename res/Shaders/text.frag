@@ -0,0 +1,12 @@
+#version 330 core
+
+in vec2 v_TexCoords;
+layout(location = 0) out vec4 final;
+
+uniform vec3 u_Color = vec3(1.0, 1.0, 1.0);
+uniform sampler2D u_Texture;
+
+void main() {
+	// The atlas only stores coverage in the red channel.
+	final = vec4(u_Color, texture(u_Texture, v_TexCoords).r);
+}
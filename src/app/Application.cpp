@@ -1,14 +1,35 @@
 #include "pch.hpp"
 #include "Core/Event.hpp"
 #include "Core/Window.hpp"
+#include "Core/Clock.hpp"
+#include "Core/InputRecording.hpp"
+#include "Core/Options.hpp"
+#include "Math/FastTrig.hpp"
 #include "Math/Geometrics.hpp"
 #include "Primitives/Floor.hpp"
 #include "Primitives/FloorTexture.hpp"
 #include "Primitives/NodeRenderer.hpp"
 #include "Casters/AngleCaster.hpp"
 #include "Casters/EndPointCaster.hpp"
+#include "Casters/AreaCaster.hpp"
+#include "Casters/PenumbraCaster.hpp"
+#include "Casters/CastWorker.hpp"
+#include "Render/CommandQueue.hpp"
+#include "Scene/Occluders.hpp"
+#include "Scene/SceneGenerator.hpp"
+#include "Scene/SegmentGrid.hpp"
+#include "Render/Screenshot.hpp"
+#include "Render/TextRenderer.hpp"
+#include "Profile/CastStats.hpp"
+#include "Profile/FrameLog.hpp"
+#include "Profile/Latency.hpp"
+#include "Profile/Trace.hpp"
 #include "Debug.hpp"
+#include "Fence.hpp"
+#include "Framebuffer.hpp"
+#include "Timer.hpp"
 #include "Shader.hpp"
+#include "State.hpp"
 
 // Code Signing: https://stackoverflow.com/questions/16673086/how-to-correctly-sign-an-executable/48244156
 
@@ -17,6 +38,16 @@ using namespace lwvl::debug;
 constexpr uint32_t CIRCLE_SLICES = 32;
 constexpr float M_TAU = 6.283185307179586f;
 
+// The light radius when a limit is first switched on, and how much each step grows or shrinks it, in pixels.
+constexpr float DEFAULT_LIGHT_RADIUS = 256.0f;
+constexpr float LIGHT_RADIUS_STEP = 1.25f;
+
+// The radius of the disk area lights and penumbra wedges are computed for, in pixels.
+constexpr float AREA_LIGHT_SIZE = 12.0f;
+
+// Exponential smoothing for the numbers on the HUD, so they are readable while they change.
+constexpr double HUD_SMOOTHING = 0.1;
+
 
 struct CasterConfig {
     float prevX, prevY;
@@ -39,21 +70,65 @@ static inline double delta(std::chrono::time_point<std::chrono::steady_clock> st
 }
 
 
+// What changed since the last presented frame. Nothing is drawn while all of it is clean.
+struct Damage {
+    bool scene = true;   // Bounds visibility or render mode.
+    bool light = true;   // New caster results.
+    bool window = true;  // The window system lost the contents.
+
+    [[nodiscard]] bool any() const { return scene || light || window; }
+
+    void clear() { scene = light = window = false; }
+};
+
+
+// How the CPU is held back from running ahead of the GPU.
+enum class Pacing {
+    None,    // The driver queues frames as it sees fit.
+    Finish,  // glFinish after every swap.
+    Fence    // Wait on a fence from the previous swap before sampling input.
+};
+
+
 typedef enum {
     LineAngle = 0,
     FilledAngle = 1,
     LineEndpoint = 2,
-    FilledEndpoint = 3
+    FilledEndpoint = 3,
+    AreaLight = 4,
+    Penumbra = 5
 } RenderMode;
 
+static const char *renderModeNames[] = {
+    "Line angle", "Filled angle", "Line endpoint", "Filled endpoint", "Area light", "Penumbra"
+};
+
+
+static inline double milliseconds(std::chrono::steady_clock::duration duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
 
 class Application {
+    Options options;
     Window window;
 
+    static Config windowConfig(uint32_t width, uint32_t height, const Options &options) {
+        Config config(width, height);
+        config.visible = !options.headless;
+        return config;
+    }
+
 public:
-    Application(uint32_t width, uint32_t height) : window({width, height}, "RayCasting") {}
+    Application(uint32_t width, uint32_t height, Options options) :
+        options(std::move(options)), window(windowConfig(width, height, this->options), "RayCasting") {
+        // The window loaded GL, so lwvl can now tell whether the context has direct state access.
+        lwvl::initState();
+    }
 
     int run() {
+        TRACE_THREAD("main");
+
 #ifndef NDEBUG
         GLEventListener listener(
             [](
@@ -74,6 +149,23 @@ public:
             frameHeight = static_cast<float>(height);
         }
 
+        // Headless frames are drawn into a texture the size of the window instead of the hidden window's back buffer.
+        //   The texture takes slot 2 so creating it does not disturb the floor or font textures.
+        std::optional<lwvl::Texture2D> offscreenColor;
+        std::optional<lwvl::Framebuffer> offscreen;
+        if (options.headless) {
+            offscreenColor.emplace();
+            offscreenColor->slot(2);
+            offscreenColor->construct(
+                static_cast<uint32_t>(frameWidth), static_cast<uint32_t>(frameHeight), nullptr,
+                lwvl::ChannelLayout::RGBA, lwvl::ChannelOrder::RGBA, lwvl::ByteFormat::UnsignedByte
+            );
+            offscreenColor->filter(lwvl::Filter::Nearest);
+
+            offscreen.emplace();
+            offscreen->attach(lwvl::Attachment::Color, offscreenColor.value());
+        }
+
         const float wPad = (10.0f * frameWidth) / 800.0f;
         const float hPad = (10.0f * frameHeight) / 600.0f;
 
@@ -82,7 +174,10 @@ public:
 
         Floor floor(wPad, hPad, floorWidth, floorHeight);
         FloorTexture floorBuffer;
-        floorBuffer.render(static_cast<uint32_t>(floorWidth), static_cast<uint32_t>(floorHeight));
+        {
+            TRACE_SCOPE("render floor texture");
+            floorBuffer.render(static_cast<uint32_t>(floorWidth), static_cast<uint32_t>(floorHeight));
+        }
 
         // ****** Construct Shaders ******
         //std::array<float, 16> projection {
@@ -94,26 +189,33 @@ public:
 
         // **** Line Render Control ****
         lwvl::ShaderProgram lineControl;
-        lineControl.link(
-            lwvl::VertexShader::readFile("Data/Shaders/default.vert"),
-            lwvl::FragmentShader::readFile("Data/Shaders/default.frag")
-        );
-        lineControl.bind();
+        {
+            TRACE_SCOPE("link line shader");
+            lineControl.link(
+                lwvl::VertexShader::readFile("Data/Shaders/default.vert"),
+                lwvl::FragmentShader::readFile("Data/Shaders/default.frag")
+            );
+        }
         lineControl.uniform("u_Projection").set2DOrthographic(frameHeight, 0.0f, frameWidth, 0.0f);
         lineControl.uniform("u_Color").set3f(1.0f, 1.0f, 1.0f);
 
         // **** Ray-Caster Render Control ****
         lwvl::ShaderProgram lightControl;
-        lightControl.link(
-            lwvl::VertexShader::readFile("Data/Shaders/light.vert"),
-            lwvl::FragmentShader::readFile("Data/Shaders/light.frag")
-        );
-        lightControl.bind();
+        {
+            TRACE_SCOPE("link light shader");
+            lightControl.link(
+                lwvl::VertexShader::readFile("Data/Shaders/light.vert"),
+                lwvl::FragmentShader::readFile("Data/Shaders/light.frag")
+            );
+        }
         lightControl.uniform("u_Projection").set2DOrthographic(frameHeight, 0.0f, frameWidth, 0.0f);
         lightControl.uniform("u_Resolution").set2f(floorWidth, floorHeight);
         lightControl.uniform("u_Offset").set2f(wPad, hPad);
         lightControl.uniform("u_Texture").set1i(int32_t(floorBuffer.slot()));
         lwvl::Uniform lightCenter = lightControl.uniform("u_MouseCoords");
+        lwvl::Uniform lightIntensity = lightControl.uniform("u_Intensity");
+        lightIntensity.set1f(1.0f);
+        lightControl.uniform("u_LightSize").set1f(AREA_LIGHT_SIZE);
 
         lightControl.uniform("u_LightColor").set3f(1.00000f, 0.00000f, 0.00000f);  // Red
         //lightControl.uniform("u_LightColor").set3f(0.05098f, 0.19608f, 0.30196f);  // Prussian Blue
@@ -123,26 +225,40 @@ public:
 
         // **** Background Render Control ****
         lwvl::ShaderProgram floorControl;
-        floorControl.link(
-            lwvl::VertexShader::readFile("Data/Shaders/floor.vert"),
-            lwvl::FragmentShader::readFile("Data/Shaders/floor.frag")
-        );
-        floorControl.bind();
+        {
+            TRACE_SCOPE("link floor shader");
+            floorControl.link(
+                lwvl::VertexShader::readFile("Data/Shaders/floor.vert"),
+                lwvl::FragmentShader::readFile("Data/Shaders/floor.frag")
+            );
+        }
         floorControl.uniform("u_Projection").set2DOrthographic(frameHeight, 0.0f, frameWidth, 0.0f);
         floorControl.uniform("u_Texture").set1i(int32_t(floorBuffer.slot()));
 
-        NodeRenderer<12 + CIRCLE_SLICES> bounds;
-        {
+        Occluders occluders;
+        if (options.scene.has_value()) {
+            TRACE_SCOPE("generate scene");
+
+            SceneSpec spec = options.scene.value();
+            spec.left = wPad;
+            spec.bottom = hPad;
+            spec.width = floorWidth;
+            spec.height = floorHeight;
+            occluders.addSegments(generateScene(spec));
+
+            std::cout << "Generated " << sceneKindName(spec.kind) << " scene with " << occluders.segments().size()
+                      << " segments from seed " << spec.seed << '.' << std::endl;
+        } else {
+            TRACE_SCOPE("build bounds");
+
             // Bounding Wall
             Point frameWallA{wPad, hPad};
             Point frameWallB{frameWidth - wPad, hPad};
             Point frameWallC{frameWidth - wPad, frameHeight - hPad};
             Point frameWallD{wPad, frameHeight - hPad};
 
-            bounds.add({frameWallA, frameWallB});
-            bounds.add({frameWallB, frameWallC});
-            bounds.add({frameWallC, frameWallD});
-            bounds.add({frameWallD, frameWallA});
+            // Clockwise, since the room is inside it.
+            occluders.addPolygon({frameWallA, frameWallD, frameWallC, frameWallB});
 
             const float width14 = frameWidth / 4.0f;
             const float height14 = frameHeight / 4.0f;
@@ -155,10 +271,7 @@ public:
             Point westWallC{width14 + wPad, height34 + hPad};
             Point westWallD{width14 - wPad, height34 + hPad};
 
-            bounds.add({westWallA, westWallB});
-            bounds.add({westWallB, westWallC});
-            bounds.add({westWallC, westWallD});
-            bounds.add({westWallD, westWallA});
+            occluders.addPolygon({westWallA, westWallB, westWallC, westWallD});
 
             // East Wall
             Point eastWallA{width34 - wPad, height14 - hPad};
@@ -166,10 +279,7 @@ public:
             Point eastWallC{width34 + wPad, height34 + hPad};
             Point eastWallD{width34 - wPad, height34 + hPad};
 
-            bounds.add({eastWallA, eastWallB});
-            bounds.add({eastWallB, eastWallC});
-            bounds.add({eastWallC, eastWallD});
-            bounds.add({eastWallD, eastWallA});
+            occluders.addPolygon({eastWallA, eastWallB, eastWallC, eastWallD});
 
             // Center Circle
             Point center = {frameWidth / 2.0f, frameHeight / 2.0f};
@@ -179,22 +289,97 @@ public:
             //			float radius = frameHeight / 4.0f;
             float radius = (height34 - height14) / 2.0f;
 
-            Point prevPoint{radius * std::cosf(0.0f) + center.x, radius * std::sinf(0.0f) + center.y};
-            for (uint32_t i = 1; i < circleSlices + 1; i++) {
+            std::vector<Point> circle;
+            for (uint32_t i = 0; i < circleSlices; i++) {
                 float angle = static_cast<float>(i) * slice;
-                Point newPoint{radius * std::cosf(angle) + center.x, radius * std::sinf(angle) + center.y};
-                bounds.add({newPoint, prevPoint});
-                prevPoint = newPoint;
+                circle.push_back({radius * std::cosf(angle) + center.x, radius * std::sinf(angle) + center.y});
             }
+            occluders.addPolygon(circle);
         }
+
+        NodeRenderer bounds(occluders.segments().size());
+        bounds.add(occluders.segments());
         bounds.update();
 
         const unsigned int numBounds = bounds.size();
-        CasterConfig casters[4]{};
-        casters[FilledEndpoint].setCaster(std::make_unique<FilledEndPointCaster>(numBounds));
-        casters[LineEndpoint].setCaster(std::make_unique<LineEndPointCaster>(numBounds));
-        casters[FilledAngle].setCaster(std::make_unique<FilledAngleCaster>());
-        casters[LineAngle].setCaster(std::make_unique<LineAngleCaster>());
+        CasterConfig casters[6]{};
+        {
+            TRACE_SCOPE("create casters");
+            casters[FilledEndpoint].setCaster(std::make_unique<FilledEndPointCaster>(numBounds));
+            casters[LineEndpoint].setCaster(std::make_unique<LineEndPointCaster>(numBounds));
+            casters[FilledAngle].setCaster(std::make_unique<FilledAngleCaster>(options.rays));
+            casters[LineAngle].setCaster(std::make_unique<LineAngleCaster>(options.rays));
+            casters[AreaLight].setCaster(std::make_unique<AreaCaster>(options.samples, AREA_LIGHT_SIZE));
+            casters[Penumbra].setCaster(std::make_unique<PenumbraCaster>(AREA_LIGHT_SIZE));
+        }
+        const auto areaSamples = static_cast<float>(static_cast<AreaCaster &>(*casters[AreaLight].caster).samples());
+
+        bool robust = options.robust;
+        const auto setRobust = [&]() {
+            for (CasterConfig &config : casters) {
+                config.caster->robust(robust);
+            }
+        };
+        setRobust();
+
+        bool fastTrig = options.fastTrig;
+        const auto setTrig = [&]() {
+            for (CasterConfig &config : casters) {
+                config.caster->trig(fastTrig ? TrigPrecision::Fast : TrigPrecision::Libm);
+            }
+        };
+        setTrig();
+
+        // Indexed once here, before the cast worker starts, since the casters read the grid without a lock.
+        const SegmentGrid grid(bounds.segments());
+        for (CasterConfig &config : casters) {
+            config.caster->index(&grid);
+        }
+
+        bool limitRadius = options.radius > 0.0f;
+        float lightRadius = limitRadius ? options.radius : DEFAULT_LIGHT_RADIUS;
+        const auto setRadius = [&]() {
+            for (CasterConfig &config : casters) {
+                config.caster->radius(limitRadius ? lightRadius : 0.0f);
+            }
+
+            if (limitRadius) {
+                std::cout << "Light radius " << lightRadius << std::endl;
+            }
+        };
+        setRadius();
+
+        // Area lights cast from points around the light, which may see edges its center cannot.
+        bool cull = options.cull;
+        const auto setCulling = [&]() {
+            for (RenderMode mode : {FilledEndpoint, LineEndpoint, FilledAngle, LineAngle, Penumbra}) {
+                casters[mode].caster->occluders(cull ? &occluders : nullptr);
+            }
+        };
+        setCulling();
+
+        bool coherent = options.coherent;
+        const auto setCoherent = [&]() {
+            for (CasterConfig &config : casters) {
+                config.caster->coherent(coherent);
+            }
+        };
+        setCoherent();
+
+        bool sorted = options.sorted;
+        const auto setSorted = [&]() {
+            for (CasterConfig &config : casters) {
+                config.caster->sorted(sorted);
+            }
+        };
+        setSorted();
+
+        bool adaptive = options.adaptive;
+        const auto setAdaptive = [&]() {
+            static_cast<FilledAngleCaster &>(*casters[FilledAngle].caster).adaptive(adaptive);
+            static_cast<LineAngleCaster &>(*casters[LineAngle].caster).adaptive(adaptive);
+        };
+        setAdaptive();
 
 #ifndef NDEBUG
         std::cout << "Setup took " << delta(setupStart) << " seconds." << std::endl;
@@ -206,24 +391,176 @@ public:
 
         const auto changeRenderMode = [&](RenderMode newMode) {
             renderMode = newMode;
-            lightControl.bind();
             lightCenter.set2f(casters[newMode].prevX, frameHeight - casters[newMode].prevY);
+
+            // Each sample of an area light adds its share of the light.
+            lightIntensity.set1f(newMode == AreaLight ? 1.0f / areaSamples : 1.0f);
         };
 
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-        while (!window.shouldClose()) {
-            // Fill event stack
-            Window::update();
+        // Casting on a worker thread. Age is how many frames old a result is when it is uploaded.
+        std::optional<CastWorker> worker;
+        uint64_t staleFrames = 0;
+        uint64_t staleMax = 0;
+        uint64_t uploadedResults = 0;
+
+        const auto stopWorker = [&]() {
+            const CastWorkerStats stats = worker->stats();
+            worker.reset();
+
+            std::cout << "Threaded casting: " << stats.published << " results, "
+                      << stats.dropped << " dropped, " << stats.superseded << " requests superseded. ";
+            if (uploadedResults != 0) {
+                std::cout << "Average age " << static_cast<double>(staleFrames) / static_cast<double>(uploadedResults)
+                          << " frames, max " << staleMax << '.';
+            }
+            std::cout << std::endl;
 
-            // Handle incoming events
-            while (std::optional<Event> possible = window.pollEvent()) {
+            staleFrames = staleMax = uploadedResults = 0;
+        };
+
+        // Layers keep the floor under the light and the bounds on top of both.
+        CommandQueue queue;
+        const Material floorMaterial{&floorControl, &floorBuffer, BlendMode::Opaque, 0, "floor"};
+        const Material lightMaterial{&lightControl, &floorBuffer, BlendMode::Alpha, 1, "light"};
+        const Material areaLightMaterial{&lightControl, &floorBuffer, BlendMode::Additive, 1, "area light"};
+        const Material innerPenumbraMaterial{&lightControl, &floorBuffer, BlendMode::Lighten, 2, "inner penumbra"};
+        const Material outerPenumbraMaterial{&lightControl, &floorBuffer, BlendMode::Darken, 3, "outer penumbra"};
+        const Material boundsMaterial{&lineControl, nullptr, BlendMode::Opaque, 4, "bounds"};
+
+        GpuTimer gpuTimer;
+        queue.profile(&gpuTimer);
+
+        // Casting work per presented frame. Casts on the worker are counted when their results are taken.
+        constexpr double castLogInterval = 2.0;
+        CastStatsLog castLog;
+        CastStats frameCasting;
+        bool logCasting = false;
+
+        // The HUD is drawn last, over everything, from its own atlas on texture slot 1.
+        TextRenderer hud(frameWidth, frameHeight, 1);
+        const Material hudMaterial{&hud.program(), &hud.atlas(), BlendMode::Alpha, 5, "hud"};
+        bool showHud = true;
+        double frameTime = 0.0;
+        double castTime = 0.0;
+        double hudTime = 0.0;
+        auto lastPresent = std::chrono::steady_clock::now();
+
+        const auto smooth = [](double &average, double sample) {
+            average += HUD_SMOOTHING * (sample - average);
+        };
+
+        // lwvl and the queue count per frame; keep running totals for the summary at exit.
+        uint64_t frames = 0;
+        lwvl::StateCounters bindTotals;
+        RenderMetrics renderTotals;
+
+        // When idle aware, the loop sleeps in wait instead of polling while nothing is damaged.
+        //   The timeout bounds how long a missed wake up could stall the loop.
+        constexpr double idleTimeout = 0.25;
+        bool idleAware = true;
+        Damage damage;
+        uint64_t skippedFrames = 0;
+
+        UsageMeter idleAwareUsage;
+        UsageMeter continuousUsage;
+        idleAwareUsage.start();
+
+        // Input latency. Low latency mode polls again right before the cursor is sampled,
+        //   so motion that arrived while the previous frame was presented is not a frame behind.
+        bool lowLatency = false;
+        bool vsync = true;
+        Pacing pacing = Pacing::None;
+        lwvl::Fence frameFence;
+        constexpr uint64_t fenceTimeout = 100000000;  // 100ms
+        LatencyTracker latency;
+
+        // When the newest cursor motion handled this frame was reported.
+        std::optional<std::chrono::steady_clock::time_point> motionTime;
+
+        // A replay stands in for the window's input and runs unthrottled, drawing every frame,
+        //   so the per frame timings of two builds replaying the same file are comparable.
+        std::optional<InputRecorder> recorder;
+        std::optional<InputReplay> replay;
+        FrameLog frameLog;
+        double frameCastTime = 0.0;
+        if (!options.record.empty()) {
+            recorder.emplace(options.record);
+        }
+        if (!options.replay.empty()) {
+            replay.emplace(options.replay);
+        }
+
+        const bool unthrottled = replay.has_value() || options.bench || options.headless;
+        if (unthrottled) {
+            vsync = false;
+            Window::swapInterval(0);
+        }
+
+        // Benchmarks without a recording move the light along a fixed path so every frame casts.
+        const auto benchCursor = [&]() -> std::pair<double, double> {
+            const auto t = static_cast<float>(frames);
+            return {
+                0.5f * frameWidth + 0.45f * floorWidth * std::sin(0.031f * t),
+                0.5f * frameHeight + 0.45f * floorHeight * std::sin(0.047f * t)
+            };
+        };
+
+        const auto nextEvent = [&]() -> std::optional<Event> {
+            if (!replay.has_value()) {
+                return window.pollEvent();
+            }
+
+            // Only closing is taken from the window while replaying.
+            while (std::optional<Event> live = window.pollEvent()) {
+                if (
+                    live->type == Event::Type::KeyRelease
+                    && std::get<KeyboardEvent>(live->event).key == GLFW_KEY_ESCAPE
+                    ) {
+                    window.shouldClose(true);
+                }
+            }
+
+            return replay->pollEvent();
+        };
+
+        const auto sampleCursor = [&]() -> std::pair<double, double> {
+            double x, y;
+            if (replay.has_value()) {
+                std::tie(x, y) = replay->cursor();
+            } else if (options.bench) {
+                std::tie(x, y) = benchCursor();
+            } else {
+                const auto position = window.cursorPosition();
+                x = position.x();
+                y = position.y();
+            }
+
+            if (recorder.has_value()) {
+                recorder->cursor(x, y);
+            }
+
+            return {x, y};
+        };
+
+        const auto handleEvents = [&]() {
+            TRACE_SCOPE("events");
+            while (std::optional<Event> possible = nextEvent()) {
                 if (!possible.has_value()) {
                     continue;
                 }
 
                 Event &concrete = possible.value();
+                if (recorder.has_value()) {
+                    recorder->event(concrete);
+                }
+
+                if (concrete.type == Event::Type::MouseMotion) {
+                    motionTime = concrete.time;
+                }
+
                 if (concrete.type == Event::Type::KeyRelease) {
+                    damage.scene = true;
+
                     KeyboardEvent &keyboardEvent = std::get<KeyboardEvent>(concrete.event);
                     switch (keyboardEvent.key) {
                         case GLFW_KEY_ESCAPE:window.shouldClose(true);
@@ -236,21 +573,142 @@ public:
                             break;
                         case GLFW_KEY_4:changeRenderMode(LineAngle);
                             break;
+                        case GLFW_KEY_5:changeRenderMode(AreaLight);
+                            break;
+                        case GLFW_KEY_6:changeRenderMode(Penumbra);
+                            break;
                         case GLFW_KEY_B:showBounds ^= true;
                             break;
                         case GLFW_KEY_SPACE:followMouse ^= true;
                             break;
+                        case GLFW_KEY_I:
+                            idleAware ^= true;
+                            (idleAware ? continuousUsage : idleAwareUsage).stop();
+                            (idleAware ? idleAwareUsage : continuousUsage).start();
+                            break;
+                        case GLFW_KEY_T:
+                            if (worker.has_value()) {
+                                stopWorker();
+                            } else {
+                                worker.emplace(bounds.segments(), &Window::wake);
+                            }
+                            break;
+                        case GLFW_KEY_L:lowLatency ^= true;
+                            break;
+                        case GLFW_KEY_P:
+                            pacing = pacing == Pacing::None ? Pacing::Finish
+                                                            : pacing == Pacing::Finish ? Pacing::Fence : Pacing::None;
+                            break;
+                        case GLFW_KEY_G:gpuTimer.print(std::cout);
+                            break;
+                        case GLFW_KEY_C:logCasting ^= true;
+                            break;
+                        case GLFW_KEY_H:showHud ^= true;
+                            break;
+                        case GLFW_KEY_R:
+                            robust ^= true;
+                            setRobust();
+                            std::cout << "Robust predicates " << (robust ? "on" : "off") << std::endl;
+                            break;
+                        case GLFW_KEY_F:
+                            fastTrig ^= true;
+                            setTrig();
+                            std::cout << "Fast trig " << (fastTrig ? "on" : "off") << std::endl;
+                            break;
+                        case GLFW_KEY_K:
+                            limitRadius ^= true;
+                            setRadius();
+                            break;
+                        case GLFW_KEY_LEFT_BRACKET:
+                            lightRadius /= LIGHT_RADIUS_STEP;
+                            setRadius();
+                            break;
+                        case GLFW_KEY_RIGHT_BRACKET:
+                            lightRadius *= LIGHT_RADIUS_STEP;
+                            setRadius();
+                            break;
+                        case GLFW_KEY_A:
+                            adaptive ^= true;
+                            setAdaptive();
+                            std::cout << "Adaptive angle rays " << (adaptive ? "on" : "off") << std::endl;
+                            break;
+                        case GLFW_KEY_O:
+                            cull ^= true;
+                            setCulling();
+                            std::cout << "Back face culling " << (cull ? "on" : "off") << std::endl;
+                            break;
+                        case GLFW_KEY_N: {
+                            coherent ^= true;
+                            setCoherent();
+                            std::cout << "Hit coherence " << (coherent ? "on" : "off") << std::endl;
+
+                            // Float rays are traced in packets or in one sweep, so only robust or refining rays
+                            //   are cast on their own and have a previous hit to start from.
+                            const bool angleMode = renderMode == FilledAngle || renderMode == LineAngle;
+                            if (floatHits && !robust && !(angleMode && adaptive)) {
+                                std::cout << "  No effect here without robust mode"
+                                          << (angleMode ? " or adaptive rays" : "") << '.' << std::endl;
+                            }
+                            break;
+                        }
+                        case GLFW_KEY_S:
+                            sorted ^= true;
+                            setSorted();
+                            std::cout << "Distance sorted hit search " << (sorted ? "on" : "off") << std::endl;
+                            break;
+                        case GLFW_KEY_V:
+                            vsync ^= true;
+                            Window::swapInterval(vsync ? 1 : 0);
+                            break;
                         default:break;
                     }
                 }
             }
+        };
+
+        while (!window.shouldClose()) {
+            TRACE_SCOPE("frame");
+            if (options.frames != 0 && frames >= options.frames) {
+                break;
+            }
+
+            if (replay.has_value() && !replay->advance()) {
+                break;
+            }
+
+            const auto frameStart = std::chrono::steady_clock::now();
+            frameCastTime = 0.0;
+            lwvl::resetStateCounters();
+
+            // Hold input sampling back until the previous frame is done on the GPU.
+            if (pacing == Pacing::Fence) {
+                frameFence.wait(fenceTimeout);
+            }
+
+            // Fill event queue
+            const bool continuous = !idleAware || unthrottled;
+            if (!continuous && !damage.any()) {
+                window.wait(idleTimeout);
+            } else {
+                window.update();
+            }
+
+            damage.window |= window.damaged() || continuous;
+
+            // Handle incoming events
+            handleEvents();
 
             // Update engine
             CasterConfig &config = casters[renderMode];
             auto &caster = config.caster;
 
             if (followMouse) {
-                const auto[mouseXd, mouseYd] = window.cursorPosition();
+                if (lowLatency) {
+                    window.update();
+                    handleEvents();
+                }
+
+                const auto[mouseXd, mouseYd] = sampleCursor();
                 const auto mouseX = static_cast<float>(mouseXd);
                 const auto mouseY = static_cast<float>(mouseYd);
 
@@ -258,40 +716,236 @@ public:
                     !(mouseX == config.prevX && mouseY == config.prevY)
                     && !(mouseX < wPad || mouseX > frameWidth - wPad || mouseY < hPad || mouseY > frameHeight - hPad)
                     ) {
-                    lightControl.bind();
-                    lightCenter.set2f(mouseX, frameHeight - mouseY);
-                    caster->update(mouseX, frameHeight - mouseY);
-                    caster->look(bounds.segments());
+                    const auto input = motionTime.value_or(std::chrono::steady_clock::now());
+                    if (worker.has_value()) {
+                        worker->request(*caster, {mouseX, frameHeight - mouseY}, frames, input);
+                    } else {
+                        lightCenter.set2f(mouseX, frameHeight - mouseY);
+                        {
+                            TRACE_SCOPE("update");
+                            caster->update(mouseX, frameHeight - mouseY);
+                        }
+                        const auto lookStart = std::chrono::steady_clock::now();
+                        {
+                            TRACE_SCOPE("look");
+                            caster->look(bounds.segments());
+                        }
+                        frameCastTime = milliseconds(std::chrono::steady_clock::now() - lookStart);
+                        smooth(castTime, frameCastTime);
+                        damage.light = true;
+
+                        // look casts and uploads in one call, so both stages share a timestamp.
+                        const auto looked = std::chrono::steady_clock::now();
+                        latency.input(input);
+                        latency.cast(looked);
+                        latency.upload(looked);
+                    }
                 }
 
                 config.prevX = mouseX;
                 config.prevY = mouseY;
             }
 
+            motionTime.reset();
+
+            // Take the newest finished cast without waiting for one.
+            if (worker.has_value()) {
+                if (CastResult *result = worker->latest()) {
+                    {
+                        TRACE_SCOPE("upload");
+                        result->caster->upload(result->output);
+                    }
+                    if (result->caster == caster.get()) {
+                        lightCenter.set2f(result->origin.x, result->origin.y);
+                        damage.light = true;
+
+                        latency.input(result->input);
+                        latency.cast(result->finished);
+                        frameCastTime = milliseconds(result->finished - result->started);
+                        smooth(castTime, frameCastTime);
+                        latency.upload();
+                    }
+
+                    frameCasting += result->stats;
+
+                    const uint64_t age = frames - result->frame;
+                    staleFrames += age;
+                    staleMax = std::max(staleMax, age);
+                    uploadedResults++;
+                }
+            }
+
+            // The last presented frame is still correct.
+            if (!damage.any()) {
+                if (recorder.has_value()) {
+                    recorder->endFrame();
+                }
+
+                skippedFrames++;
+                continue;
+            }
+
+            damage.clear();
+
             // Rendering
-            lwvl::clear();
+            gpuTimer.frame();
+            {
+                // Building the floor texture leaves the default framebuffer bound.
+                if (offscreen.has_value()) {
+                    offscreen->bind();
+                }
+
+                GpuTimer::Scope frameScope(gpuTimer, "frame");
+                lwvl::clear();
+
+                queue.record(floorMaterial, floor.drawCall());
+                queue.record(renderMode == AreaLight ? areaLightMaterial : lightMaterial, caster->drawCall());
+                if (renderMode == Penumbra) {
+                    auto &penumbra = static_cast<PenumbraCaster &>(*caster);
+                    queue.record(innerPenumbraMaterial, penumbra.innerWedgeDrawCall());
+                    queue.record(outerPenumbraMaterial, penumbra.outerWedgeDrawCall());
+                }
+                if (showBounds) {
+                    queue.record(boundsMaterial, bounds.drawCall());
+                }
+
+                if (showHud) {
+                    TRACE_SCOPE("hud");
+                    const auto hudStart = std::chrono::steady_clock::now();
+                    const CastStats &work = castLog.last();
+
+                    char text[256];
+                    std::snprintf(
+                        text, sizeof(text),
+                        "Frame %6.2f ms\nCast  %6.3f ms%s\nRays  %llu\nTests %llu\nPrune %5.1f%%\n"
+                        "Mode  %s\nHUD   %6.3f ms",
+                        frameTime, castTime, worker.has_value() ? " (thread)" : "",
+                        static_cast<unsigned long long>(work.rays),
+                        static_cast<unsigned long long>(work.segmentTests),
+                        100.0 * work.pruneRate(),
+                        renderModeNames[renderMode], hudTime
+                    );
+
+                    hud.begin();
+                    hud.add(wPad + 8.0f, hPad + 8.0f, text);
+                    hud.end();
+                    queue.record(hudMaterial, hud.drawCall());
+                    smooth(hudTime, milliseconds(std::chrono::steady_clock::now() - hudStart));
+                }
+
+                TRACE_SCOPE("draw");
+                queue.submit();
+            }
+
+            const auto submitted = std::chrono::steady_clock::now();
+
+            {
+                TRACE_SCOPE("swap");
+                if (offscreen.has_value()) {
+                    // Nothing is presented, so wait for the GPU to make present times comparable.
+                    glFinish();
+                } else {
+                    window.swapBuffers();
+                }
+            }
+            if (pacing == Pacing::Finish) {
+                glFinish();
+            } else if (pacing == Pacing::Fence) {
+                frameFence.place();
+            }
+
+            // Without Finish pacing this is when the swap was queued, not when it reached the screen.
+            latency.present();
 
-            floorBuffer.bind();
-            floorControl.bind();
-            floor.draw();
+            const auto presented = std::chrono::steady_clock::now();
+            smooth(frameTime, milliseconds(presented - lastPresent));
+            lastPresent = presented;
 
-            lightControl.bind();
-            caster->draw();
+            frameCasting += takeCastStats();
+            castLog.record(frameCasting);
 
-            if (showBounds) {
-                lineControl.bind();
-                bounds.draw();
+            if (recorder.has_value()) {
+                recorder->endFrame();
             }
 
-            window.swapBuffers();
+            if (!options.timings.empty() || options.bench) {
+                FrameSample sample;
+                sample.frame = frames;
+                sample.cpu = milliseconds(submitted - frameStart);
+                sample.present = milliseconds(presented - frameStart);
+                sample.cast = frameCastTime;
+                sample.rays = frameCasting.rays;
+                sample.segmentTests = frameCasting.segmentTests;
+                sample.drawCalls = queue.metrics().drawCalls;
+                frameLog.record(sample);
+            }
+            frameCasting = CastStats();
+            if (logCasting) {
+                castLog.periodic(std::cout, castLogInterval);
+            }
+
+            const lwvl::StateCounters bindCounts = lwvl::stateCounters();
+            bindTotals.issued += bindCounts.issued;
+            bindTotals.skipped += bindCounts.skipped;
+            renderTotals.drawCalls += queue.metrics().drawCalls;
+            renderTotals.stateChanges += queue.metrics().stateChanges;
+            frames++;
+        }
+
+        if (worker.has_value()) {
+            stopWorker();
+        }
+
+        idleAwareUsage.stop();
+        continuousUsage.stop();
+        std::cout << "Presented " << frames << " frames, skipped " << skippedFrames << " idle iterations." << std::endl;
+        std::cout << "CPU usage: " << 100.0 * idleAwareUsage.usage() << "% of a core over "
+                  << idleAwareUsage.seconds() << "s idle aware, " << 100.0 * continuousUsage.usage()
+                  << "% over " << continuousUsage.seconds() << "s continuous." << std::endl;
+        latency.print(std::cout);
+
+        if (recorder.has_value()) {
+            std::cout << "Recorded " << recorder->frames() << " frames of input to " << options.record << '.' << std::endl;
+        }
+
+        if (!options.screenshot.empty()) {
+            if (!offscreen.has_value()) {
+                glReadBuffer(GL_FRONT);
+            }
+
+            writeScreenshot(options.screenshot, static_cast<int32_t>(frameWidth), static_cast<int32_t>(frameHeight));
+            std::cout << "Wrote the last frame to " << options.screenshot << '.' << std::endl;
         }
 
+        if (options.bench) {
+            frameLog.summary(std::cout);
+        }
+
+        if (!options.timings.empty()) {
+            frameLog.writeCsv(options.timings);
+            std::cout << "Wrote " << frameLog.samples().size() << " frame timings to " << options.timings << '.' << std::endl;
+        }
+
+        castLog.summary(std::cout);
+        gpuTimer.print(std::cout);
+        TRACE_WRITE("trace.json");
+
+#ifndef NDEBUG
+        if (frames != 0) {
+            std::cout << "Binds per frame: " << bindTotals.issued / frames << " issued, "
+                      << bindTotals.skipped / frames << " skipped. Direct state access "
+                      << (lwvl::directStateAccess() ? "enabled." : "disabled.") << std::endl;
+            std::cout << "Per frame: " << renderTotals.drawCalls / frames << " draw calls, "
+                      << renderTotals.stateChanges / frames << " state changes." << std::endl;
+        }
+#endif
+
         return 0;
     }
 };
 
 
-int main() {
+int main(int argc, char **argv) {
     try {
         // Borderless window
         /*RayCasting::initGLFW();
@@ -307,7 +961,12 @@ int main() {
         //RayCasting sim(800, 600);
         //sim.run();
 
-        Application app(800, 600);
+        Options options = Options::parse(argc, argv);
+        if (options.checkTrig) {
+            return checkTrigAccuracy(std::cout) ? 0 : 1;
+        }
+
+        Application app(800, 600, std::move(options));
         return app.run();
     }
 
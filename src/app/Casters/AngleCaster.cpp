@@ -1,18 +1,214 @@
 #include "pch.hpp"
 #include "AngleCaster.hpp"
+#include "Profile/CastStats.hpp"
 
 static constexpr float M_PI = 3.14159265358979323846f;
 static constexpr float M_TAU = M_PI * 2.0f;
 
+// How far apart, in pixels, two rays on different walls may land before the gap between them is split.
+static constexpr float ADAPTIVE_TOLERANCE = 0.5f;
 
-LineAngleCaster::LineAngleCaster() : pos(0.0f, 0.0f) {
-    float positions[2 * (numRays + 1)];
-    unsigned int indices[2 * numRays];
+// Each level halves a gap, so this bounds the rays one gap can take.
+static constexpr uint32_t MAX_REFINE_DEPTH = 12;
+
+// Segments the sorted sweep tests between looking at how far its rays still reach.
+static constexpr size_t REACH_INTERVAL = 16;
+
+
+// When coherent, the search starts on the segment at seed. It walks order instead of bounds unless that is nullptr.
+static Hit castAt(
+    const Point &origin, float angle, const std::vector<LineSegment> &bounds, bool exact, TrigPrecision precision,
+    bool coherent, const SegmentOrder *order, int32_t seed
+) {
+    Ray ray(origin.x, origin.y, 0.0f);
+    sinCos(precision, angle, ray.dir.y, ray.dir.x);
+    if (order != nullptr) {
+        return closestHit(ray, bounds, exact, *order, coherent ? seed : -1);
+    }
+
+    return coherent ? closestHit(ray, bounds, exact, seed) : closestHit(ray, bounds, exact);
+}
+
+// Appends the hits strictly between the rays at angles a and b, in order.
+static void refine(
+    const Point &origin, const std::vector<LineSegment> &bounds, bool exact, TrigPrecision precision, bool coherent,
+    const SegmentOrder *order, float a, const Hit &hitA, float b, const Hit &hitB, uint32_t depth,
+    std::vector<Point> &hits
+) {
+    const float reach = std::max(hitA.distance, hitB.distance);
+    if (hitA.segment == hitB.segment || depth == MAX_REFINE_DEPTH || (b - a) * reach < ADAPTIVE_TOLERANCE) {
+        return;
+    }
+
+    const float middle = 0.5f * (a + b);
+    const Hit hit = castAt(origin, middle, bounds, exact, precision, coherent, order, hitA.segment);
+    refine(origin, bounds, exact, precision, coherent, order, a, hitA, middle, hit, depth + 1, hits);
+    hits.push_back(hit.point);
+    refine(origin, bounds, exact, precision, coherent, order, middle, hit, b, hitB, depth + 1, hits);
+}
+
+
+// AngleSweep
+AngleSweep::AngleSweep(uint32_t rays) :
+    m_directions(rays), m_nearest(rays), m_segments(rays), m_coarse(rays) {}
+
+// Ray::intersects written out with the ray independent parts hoisted out of the loop over rays.
+//   u is the distance along the ray. Count is 0 when the ray count is only known at run time.
+//
+// Unless order is nullptr the segments are taken nearest first, and the sweep stops at the first one further than
+//   every ray reaches. Finding that takes a pass over the rays, so it is only looked at every REACH_INTERVAL segments.
+template<uint32_t Count>
+void AngleSweep::castUniform(const Point &origin, const std::vector<LineSegment> &bounds, const SegmentOrder *order) {
+    const uint32_t rays = Count == 0 ? m_directions.count() : Count;
+    const float *dx = m_directions.x();
+    const float *dy = m_directions.y();
+    float *nearest = m_nearest.data();
+    int32_t *segments = m_segments.data();
+
+    std::fill(nearest, nearest + rays, std::numeric_limits<float>::infinity());
+    std::fill(segments, segments + rays, -1);
+
+    uint64_t hits = 0;
+    size_t tested = 0;
+    float reach = std::numeric_limits<float>::infinity();
+    for (; tested < bounds.size(); tested++) {
+        if (order != nullptr && tested % REACH_INTERVAL == 0 && tested != 0) {
+            reach = *std::max_element(nearest, nearest + rays);
+        }
+
+        if (order != nullptr && order->nearest[tested] - ORDER_SLACK > reach) {
+            break;
+        }
+
+        const auto s = order != nullptr ? order->indices[tested] : static_cast<uint32_t>(tested);
+        const LineSegment &segment = bounds[s];
+        const float ex = segment.b.x - segment.a.x;
+        const float ey = segment.b.y - segment.a.y;
+        const float wx = segment.a.x - origin.x;
+        const float wy = segment.a.y - origin.y;
+        const float along = ex * wy - ey * wx;
+
+        for (uint32_t i = 0; i < rays; i++) {
+            const float den = ex * dy[i] - ey * dx[i];
+            const float inverse = 1.0f / den;
+            const float t = (wy * dx[i] - wx * dy[i]) * inverse;
+            const float u = along * inverse;
+
+            // & rather than && so there is no branch to stop the loop from vectorizing.
+            const bool hit = (den != 0.0f) & (t >= 0.0f) & (t <= 1.0f) & (u >= 0.0f);
+            const bool closer = hit & (u < nearest[i]);
+            hits += hit;
+            nearest[i] = closer ? u : nearest[i];
+            segments[i] = closer ? static_cast<int32_t>(s) : segments[i];
+        }
+    }
+
+    uint64_t resolved = 0;
+    for (uint32_t i = 0; i < rays; i++) {
+        if (segments[i] == -1) {
+            m_coarse[i] = {origin};
+        } else {
+            m_coarse[i] = {{origin.x + nearest[i] * dx[i], origin.y + nearest[i] * dy[i]}, nearest[i], segments[i]};
+            resolved++;
+        }
+    }
+
+    CastStats &stats = castStats();
+    stats.rays += rays;
+    stats.segmentTests += uint64_t(rays) * tested;
+    stats.pruned += uint64_t(rays) * (bounds.size() - tested);
+    stats.hits += hits;
+    stats.resolved += resolved;
+}
+
+void AngleSweep::cast(
+    const Point &origin, const std::vector<LineSegment> &bounds, bool exact, TrigPrecision precision, bool coherent,
+    bool sorted, std::vector<Point> &hits
+) {
+    const uint32_t rays = m_directions.count();
+    const bool refining = adaptive();
+
+    const SegmentOrder *order = nullptr;
+    const bool oneByOne = exact || !floatHits;
+    if (sorted) {
+        m_order.sort(origin, bounds);
+        order = &m_order;
+    }
+
+    if (oneByOne) {
+        // The robust predicates and hit tests in other scalars are not batched, so test each ray on its own.
+        Ray ray(origin.x, origin.y, 0.0f);
+        int32_t previous = -1;
+        for (uint32_t i = 0; i < rays; i++) {
+            ray.dir = {m_directions.x()[i], m_directions.y()[i]};
+            if (order != nullptr) {
+                m_coarse[i] = closestHit(ray, bounds, exact, *order, coherent ? previous : -1);
+            } else {
+                m_coarse[i] = coherent ? closestHit(ray, bounds, exact, previous) : closestHit(ray, bounds, exact);
+            }
+
+            previous = m_coarse[i].segment;
+        }
+    } else {
+        switch (rays) {
+            case 64:castUniform<64>(origin, bounds, order);
+                break;
+            case 128:castUniform<128>(origin, bounds, order);
+                break;
+            case 256:castUniform<256>(origin, bounds, order);
+                break;
+            case 512:castUniform<512>(origin, bounds, order);
+                break;
+            case 1024:castUniform<1024>(origin, bounds, order);
+                break;
+            default:castUniform<0>(origin, bounds, order);
+                break;
+        }
+    }
+
+    hits.clear();
+    if (!refining) {
+        for (uint32_t i = 0; i < rays; i++) {
+            hits.push_back(m_coarse[i].point);
+        }
+
+        return;
+    }
+
+    const float slice = M_TAU / float(rays);
+    for (uint32_t i = 0; i < rays; i++) {
+        const uint32_t next = (i + 1) % rays;
+        hits.push_back(m_coarse[i].point);
+        const float start = float(i) * slice;
+        refine(
+            origin, bounds, exact, precision, coherent, order, start, m_coarse[i], start + slice, m_coarse[next], 0,
+            hits
+        );
+    }
+}
+
+uint32_t AngleSweep::rays() const {
+    return m_directions.count();
+}
+
+void AngleSweep::adaptive(bool adaptive) {
+    m_adaptive.store(adaptive, std::memory_order_relaxed);
+}
+
+bool AngleSweep::adaptive() const {
+    return m_adaptive.load(std::memory_order_relaxed);
+}
+
+
+LineAngleCaster::LineAngleCaster(uint32_t rays) :
+    currentRays(rays), drawnRays(rays), m_sweep(rays) {
+    std::vector<float> positions(2 * (rays + 1));
+    std::vector<uint32_t> indices(2 * rays);
 
     positions[0] = pos.x;
     positions[1] = pos.y;
 
-    for (unsigned int i = 0; i < numRays; i++) {
+    for (unsigned int i = 0; i < rays; i++) {
         positions[(i + 1) * 2 + 0] = 0.0f;
         positions[(i + 1) * 2 + 1] = 0.0f;
 
@@ -20,83 +216,82 @@ LineAngleCaster::LineAngleCaster() : pos(0.0f, 0.0f) {
         indices[i * 2 + 1] = i + 1;
     }
 
-    vao.bind();
-
     // Construct array buffer.
-    vbo.bind();
     vbo.usage(lwvl::Usage::Dynamic);
-    vbo.construct(positions, 2 * (numRays + 1));
-    vao.attribute(2, GL_FLOAT, 2 * sizeof(float), 0);
+    vbo.construct(positions.begin(), positions.end());
+    vao.attribute(vbo, 2, GL_FLOAT, 2 * sizeof(float), 0);
 
     // Construct index buffer.
-    ebo.bind();
     ebo.usage(lwvl::Usage::Static);
-    ebo.construct(indices, 2 * numRays);
-
-    lwvl::VertexArray::clear();
-    lwvl::ArrayBuffer::clear();
-    lwvl::ElementBuffer::clear();
+    ebo.construct(indices.begin(), indices.end());
+    vao.elements(ebo);
 }
 
-void LineAngleCaster::update(const float x, const float y) {
-    pos.x = x;
-    pos.y = y;
-
-    float positions[2] = {x, y};
-    vbo.bind();
-    vbo.update(positions, 2);
+void LineAngleCaster::cast(
+    const Point &origin, const std::vector<LineSegment> &bounds, CastOutput &output
+) {
+    std::vector<float> &vertices = output.vertices;
+
+    // Read once so a toggle from another thread cannot change the predicates halfway through a cast.
+    const bool exact = robust();
+    m_sweep.cast(origin, bounds, exact, trig(), coherent(), sorted(), m_hits);
+
+    vertices.resize(2 * (m_hits.size() + 1));
+    vertices[0] = origin.x;
+    vertices[1] = origin.y;
+    for (size_t i = 0; i < m_hits.size(); i++) {
+        vertices[(i + 1) * 2 + 0] = m_hits[i].x;
+        vertices[(i + 1) * 2 + 1] = m_hits[i].y;
+    }
 }
 
-void LineAngleCaster::look(const std::vector<LineSegment> &bounds) {
-    float positions[2 * numRays];
-    const unsigned int numBounds = bounds.size();
-    intersections.reserve(numBounds);
-
-    Ray ray(pos.x, pos.y, 0.0f);
-    const float slice = M_TAU / float(numRays);
-
-    // Iterate over all rays to find where they intersect.
-    for (unsigned int i = 0; i < numRays; i++) {
+void LineAngleCaster::upload(const CastOutput &output) {
+    const std::vector<float> &vertices = output.vertices;
+    const auto neededRays = static_cast<uint32_t>(vertices.size() / 2 - 1);
 
-        // You would think it would be better to precompute these angles but accessing
-        // the memory it would be stored at might be slower than just computation.
-        const float angle = float(i) * slice;
-        ray.dir.x = std::cosf(angle);
-        ray.dir.y = std::sinf(angle);
-
-        const unsigned int index = i * 2;
-        pushIntersections(ray, bounds, intersections);
-        if (!intersections.empty()) {
-            Point shortestPath = closestIntersection(ray, intersections);
-
-            positions[index + 0] = shortestPath.x;
-            positions[index + 1] = shortestPath.y;
-        } else {
-            positions[index + 0] = pos.x;
-            positions[index + 1] = pos.y;
+    if (neededRays > currentRays) {
+        std::vector<uint32_t> indices(2 * neededRays);
+        for (uint32_t i = 0; i < neededRays; i++) {
+            indices[i * 2 + 0] = 0;
+            indices[i * 2 + 1] = i + 1;
         }
 
-        intersections.clear();
+        // Make new, bigger buffers on the GPU.
+        vbo.construct<float>(nullptr, vertices.size());
+        ebo.construct(indices.begin(), indices.end());
+        castStats().bytesUploaded += indices.size() * sizeof(uint32_t);
+        currentRays = neededRays;
     }
 
-    vbo.bind();
-    vbo.update(positions, 2 * numRays, 2);
+    drawnRays = neededRays;
+    vbo.update(vertices.begin(), vertices.end());
+    castStats().bytesUploaded += vertices.size() * sizeof(float);
 }
 
-void LineAngleCaster::draw() {
-    vao.bind();
-    vao.drawElements(lwvl::PrimitiveMode::Lines, 2 * numRays, lwvl::ByteFormat::UnsignedInt);
+DrawCall LineAngleCaster::drawCall() {
+    return DrawCall::elements(
+        vao, lwvl::PrimitiveMode::Lines, static_cast<int32_t>(2 * drawnRays), lwvl::ByteFormat::UnsignedInt
+    );
+}
+
+void LineAngleCaster::adaptive(bool adaptive) {
+    m_sweep.adaptive(adaptive);
+}
+
+bool LineAngleCaster::adaptive() const {
+    return m_sweep.adaptive();
 }
 
 
 // Filled AngleCaster
-FilledAngleCaster::FilledAngleCaster() : pos(0.0f, 0.0f) {
-    const unsigned int bufferSize = (numRays + 2) * 2;
-    float positions[bufferSize];
+FilledAngleCaster::FilledAngleCaster(uint32_t rays) :
+    currentRays(rays), drawnRays(rays), m_sweep(rays) {
+    const unsigned int bufferSize = (rays + 2) * 2;
+    std::vector<float> positions(bufferSize);
     positions[0] = float(pos.x);
     positions[1] = float(pos.y);
 
-    for (unsigned int i = 0; i < numRays; i++) {
+    for (unsigned int i = 0; i < rays; i++) {
         positions[(i + 1) * 2 + 0] = float(pos.x);
         positions[(i + 1) * 2 + 1] = float(pos.y);
     }
@@ -104,62 +299,56 @@ FilledAngleCaster::FilledAngleCaster() : pos(0.0f, 0.0f) {
     positions[bufferSize - 2] = positions[2];
     positions[bufferSize - 1] = positions[3];
 
-    vao.bind();
-    vbo.bind();
     vbo.usage(lwvl::Usage::Dynamic);
-    vbo.construct(positions, bufferSize);
-    vao.attribute(2, GL_FLOAT, 2 * sizeof(float), 0);
-
-    lwvl::VertexArray::clear();
-    lwvl::ArrayBuffer::clear();
+    vbo.construct(positions.begin(), positions.end());
+    vao.attribute(vbo, 2, GL_FLOAT, 2 * sizeof(float), 0);
 }
 
-void FilledAngleCaster::update(const float x, const float y) {
-    pos.x = x;
-    pos.y = y;
+void FilledAngleCaster::cast(
+    const Point &origin, const std::vector<LineSegment> &bounds, CastOutput &output
+) {
+    std::vector<float> &vertices = output.vertices;
+
+    const bool exact = robust();
+    m_sweep.cast(origin, bounds, exact, trig(), coherent(), sorted(), m_hits);
+
+    const size_t bufferSize = (m_hits.size() + 2) * 2;
+    vertices.resize(bufferSize);
+    vertices[0] = origin.x;
+    vertices[1] = origin.y;
+    for (size_t i = 0; i < m_hits.size(); i++) {
+        vertices[(i + 1) * 2 + 0] = m_hits[i].x;
+        vertices[(i + 1) * 2 + 1] = m_hits[i].y;
+    }
 
-    float positions[2] = {float(x), float(y)};
-    vbo.bind();
-    vbo.update(positions, 2);
+    // Close the fan on the first ray.
+    vertices[bufferSize - 2] = vertices[2];
+    vertices[bufferSize - 1] = vertices[3];
 }
 
-void FilledAngleCaster::look(const std::vector<LineSegment> &bounds) {
-    intersections.reserve(bounds.size());
-    const unsigned int bufferSize = (numRays + 1) * 2;
-    float positions[bufferSize];
-    positions[0] = 0.0f;
-    positions[1] = 0.0f;
+void FilledAngleCaster::upload(const CastOutput &output) {
+    const std::vector<float> &vertices = output.vertices;
+    const auto neededRays = static_cast<uint32_t>(vertices.size() / 2 - 2);
 
-    const float slice = (M_TAU / float(numRays));
-    Ray ray(pos.x, pos.y, 0.0f);
-    for (unsigned int i = 0; i < numRays; i++) {
-        const float angle = float(i) * slice;
-        ray.dir.x = std::cosf(angle);
-        ray.dir.y = std::sinf(angle);
-
-        const unsigned int index = i * 2;
-        pushIntersections(ray, bounds, intersections);
-        if (!intersections.empty()) {
-            Point shortestPath = closestIntersection(ray, intersections);
-
-            positions[index + 0] = shortestPath.x;
-            positions[index + 1] = shortestPath.y;
-        } else {
-            positions[index + 0] = pos.x;
-            positions[index + 1] = pos.y;
-        }
-
-        intersections.clear();
+    if (neededRays > currentRays) {
+        // Make new, bigger buffers on the GPU.
+        vbo.construct<float>(nullptr, vertices.size());
+        currentRays = neededRays;
     }
 
-    positions[bufferSize - 2] = positions[0];
-    positions[bufferSize - 1] = positions[1];
+    drawnRays = neededRays;
+    vbo.update(vertices.begin(), vertices.end());
+    castStats().bytesUploaded += vertices.size() * sizeof(float);
+}
+
+DrawCall FilledAngleCaster::drawCall() {
+    return DrawCall::arrays(vao, lwvl::PrimitiveMode::TriangleFan, static_cast<int32_t>(drawnRays + 2));
+}
 
-    vbo.bind();
-    vbo.update(positions, bufferSize, 2);
+void FilledAngleCaster::adaptive(bool adaptive) {
+    m_sweep.adaptive(adaptive);
 }
 
-void FilledAngleCaster::draw() {
-    vao.bind();
-    vao.drawArrays(lwvl::PrimitiveMode::TriangleFan, numRays + 2);
+bool FilledAngleCaster::adaptive() const {
+    return m_sweep.adaptive();
 }
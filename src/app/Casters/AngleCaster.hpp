@@ -2,44 +2,101 @@
 
 #include "pch.hpp"
 #include "Caster.hpp"
+#include "Math/DirectionTable.hpp"
 #include "Math/Geometrics.hpp"
 #include "VertexArray.hpp"
 #include "Buffer.hpp"
 
-// TODO: Find some way to populate an array of angle slices.
-constexpr unsigned int numRays = 64;
+// The ray count the angle casters start with.
+constexpr uint32_t defaultAngleRays = 64;
+
+/* ****** Angle Sweep ******
+* Casts evenly spaced rays all the way around a point, which cuts across corners that fall between two rays.
+*   The ray directions come from a table built once for the ray count, and every ray is tested against one
+*   segment before moving to the next, so the loop over rays runs on packed floats. Common power of two counts
+*   get their own instance of that loop with the count fixed at compile time.
+*
+* In adaptive mode those rays are only a first pass: wherever two neighboring rays hit different walls,
+*   the gap between them is split with another ray until its arc is under a pixel at the hit distance.
+*   Neighbors on the same wall are already joined by an exact edge, so open space costs nothing extra.
+*/
+class AngleSweep {
+    DirectionTable m_directions;
+    std::atomic<bool> m_adaptive{false};
+
+    // Per ray: distance to the nearest hit and the segment it is on.
+    std::vector<float> m_nearest;
+    std::vector<int32_t> m_segments;
+    std::vector<Hit> m_coarse;
+
+    // The segments by distance from the light, for sorted mode.
+    SegmentOrder m_order;
+
+    template<uint32_t Count>
+    void castUniform(const Point &origin, const std::vector<LineSegment> &bounds, const SegmentOrder *order);
+
+public:
+    explicit AngleSweep(uint32_t rays);
+
+    // The hit points of one sweep around origin, in angle order.
+    //   precision only matters to the extra rays of adaptive mode, since the rest come from the table.
+    //   coherent and sorted only matter to rays cast one at a time: exact ones, every ray when the hit tests are not
+    //   in float, and the extra rays of adaptive mode.
+    void cast(
+        const Point &origin, const std::vector<LineSegment> &bounds, bool exact, TrigPrecision precision,
+        bool coherent, bool sorted, std::vector<Point> &hits
+    );
+
+    [[nodiscard]] uint32_t rays() const;
+
+    void adaptive(bool adaptive);
+
+    [[nodiscard]] bool adaptive() const;
+};
 
 
 class LineAngleCaster : public Caster {
-    Point pos;
     lwvl::VertexArray vao;
     lwvl::ArrayBuffer vbo;
     lwvl::ElementBuffer ebo;
-    std::vector<Point> intersections;
+    unsigned int currentRays;
+    unsigned int drawnRays;
+    AngleSweep m_sweep;
+    std::vector<Point> m_hits;
 
 public:
-    LineAngleCaster();
+    explicit LineAngleCaster(uint32_t rays = defaultAngleRays);
+
+    void cast(const Point &origin, const std::vector<LineSegment> &bounds, CastOutput &output) final;
 
-    void update(float x, float y) final;
+    void upload(const CastOutput &output) final;
 
-    void look(const std::vector<LineSegment> &bounds) final;
+    DrawCall drawCall() final;
 
-    void draw() final;
+    void adaptive(bool adaptive);
+
+    [[nodiscard]] bool adaptive() const;
 };
 
 
 class FilledAngleCaster : public Caster {
-    Point pos;
     lwvl::VertexArray vao;
     lwvl::ArrayBuffer vbo;
-    std::vector<Point> intersections;
+    unsigned int currentRays;
+    unsigned int drawnRays;
+    AngleSweep m_sweep;
+    std::vector<Point> m_hits;
 
 public:
-    FilledAngleCaster();
+    explicit FilledAngleCaster(uint32_t rays = defaultAngleRays);
+
+    void cast(const Point &origin, const std::vector<LineSegment> &bounds, CastOutput &output) final;
+
+    void upload(const CastOutput &output) final;
 
-    void update(float x, float y) final;
+    DrawCall drawCall() final;
 
-    void look(const std::vector<LineSegment> &bounds) final;
+    void adaptive(bool adaptive);
 
-    void draw() final;
+    [[nodiscard]] bool adaptive() const;
 };
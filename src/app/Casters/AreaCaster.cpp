@@ -0,0 +1,73 @@
+#include "pch.hpp"
+#include "AreaCaster.hpp"
+#include "EndPoints.hpp"
+#include "Profile/CastStats.hpp"
+#include "Scene/SceneGenerator.hpp"
+
+static constexpr float M_PI = 3.14159265358979323846f;
+
+
+AreaCaster::AreaCaster(uint32_t samples, float lightRadius, uint64_t seed) :
+    m_samples(std::clamp(samples, 1u, maxAreaSamples)) {
+    // A golden angle spiral with equal area steps covers the disk evenly. Jittering each sample within its
+    //   step keeps them from lining up into visible bands.
+    SceneRandom random(seed);
+    const float golden = M_PI * (3.0f - std::sqrt(5.0f));
+    for (uint32_t i = 0; i < m_samples; i++) {
+        const float area = (static_cast<float>(i) + random.unit()) / static_cast<float>(m_samples);
+        const float angle = static_cast<float>(i) * golden + random.range(-0.5f, 0.5f) * golden;
+        const float distance = m_samples == 1 ? 0.0f : lightRadius * std::sqrt(area);
+        m_offsetX[i] = distance * std::cos(angle);
+        m_offsetY[i] = distance * std::sin(angle);
+        m_spread = std::max(m_spread, distance);
+    }
+
+    vbo.usage(lwvl::Usage::Dynamic);
+    vbo.construct<float>(nullptr, 0);
+    vao.attribute(vbo, 2, GL_FLOAT, 2 * sizeof(float), 0);
+}
+
+void AreaCaster::cast(const Point &origin, const std::vector<LineSegment> &bounds, CastOutput &output) {
+    std::vector<float> &vertices = output.vertices;
+
+    const bool exact = robust();
+    const bool seeded = coherent();
+    const TrigPrecision precision = trig();
+
+    // One order around the light's center serves every sample, allowing for how far each sits from it.
+    const SegmentOrder *order = nullptr;
+    if (sorted()) {
+        m_order.sort(origin, bounds);
+        order = &m_order;
+    }
+
+    traceDiskEndPoints(
+        origin, m_spread, m_offsetX.data(), m_offsetY.data(), m_samples, bounds, precision, exact, seeded, order,
+        intersections, vertices
+    );
+}
+
+void AreaCaster::upload(const CastOutput &output) {
+    const std::vector<float> &vertices = output.vertices;
+
+    // Grow the buffer when needed, and never shrink it.
+    if (vertices.size() > m_capacity) {
+        vbo.construct<float>(nullptr, vertices.size());
+        m_capacity = vertices.size();
+    }
+
+    // Every fan casts the same rays.
+    m_fanSize = static_cast<uint32_t>(vertices.size() / (2 * m_samples));
+    vbo.update(vertices.begin(), vertices.end());
+    castStats().bytesUploaded += vertices.size() * sizeof(float);
+}
+
+DrawCall AreaCaster::drawCall() {
+    return DrawCall::multiArrays(
+        vao, lwvl::PrimitiveMode::TriangleFan, static_cast<int32_t>(m_fanSize), static_cast<int32_t>(m_samples)
+    );
+}
+
+uint32_t AreaCaster::samples() const {
+    return m_samples;
+}
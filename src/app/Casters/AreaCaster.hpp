@@ -0,0 +1,50 @@
+#pragma once
+
+#include "pch.hpp"
+#include "Caster.hpp"
+#include "Math/Geometrics.hpp"
+#include "VertexArray.hpp"
+#include "Buffer.hpp"
+
+constexpr uint32_t maxAreaSamples = 32;
+
+
+/* ****** Area Caster ******
+* Soft shadows from a disk shaped light. A filled fan is cast from each of a fixed set of jittered sample points
+*   on the disk, and all of them are drawn in one call. Drawn at 1 / samples intensity with additive blending,
+*   the fans add up to a full light where every sample sees the floor and fade out across the penumbra.
+*
+* The rays are aimed at the wall endpoints like FilledEndPointCaster's, as seen from the center of the light, with a
+*   ray more to each side of a silhouette at the widest angle it takes from the rest of the disk. Every sample casts
+*   along those same directions, so each segment's denominator is computed once per direction and then tested
+*   against all the samples at once. The sample positions are kept as separate x and y arrays so that loop
+*   vectorizes, which makes the cost grow much slower than the sample count.
+*/
+class AreaCaster : public Caster {
+    lwvl::VertexArray vao;
+    lwvl::ArrayBuffer vbo;
+    uint32_t m_samples;
+    uint32_t m_fanSize = 0;
+
+    // How far the furthest sample sits from the center of the light.
+    float m_spread = 0.0f;
+    size_t m_capacity = 0;
+
+    // Sample positions relative to the center of the light.
+    std::array<float, maxAreaSamples> m_offsetX{};
+    std::array<float, maxAreaSamples> m_offsetY{};
+
+    std::vector<Point> intersections;
+
+public:
+    // The same seed always places the samples in the same spots, so the penumbra does not flicker.
+    AreaCaster(uint32_t samples, float lightRadius, uint64_t seed = 1);
+
+    void cast(const Point &origin, const std::vector<LineSegment> &bounds, CastOutput &output) final;
+
+    void upload(const CastOutput &output) final;
+
+    DrawCall drawCall() final;
+
+    [[nodiscard]] uint32_t samples() const;
+};
@@ -0,0 +1,84 @@
+#include "pch.hpp"
+#include "CastWorker.hpp"
+#include "Profile/Trace.hpp"
+
+
+CastWorker::CastWorker(const std::vector<LineSegment> &bounds, std::function<void()> notify) :
+    m_bounds(bounds), m_notify(std::move(notify)), m_thread(&CastWorker::run, this) {}
+
+CastWorker::~CastWorker() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = false;
+    }
+
+    m_wake.notify_one();
+    m_thread.join();
+}
+
+void CastWorker::run() {
+    TRACE_THREAD("cast worker");
+
+    while (true) {
+        std::optional<Request> request;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this] { return !m_running || m_request.has_value(); });
+            if (!m_running) {
+                return;
+            }
+
+            request.swap(m_request);
+        }
+
+        CastResult &result = m_results.back();
+        result.caster = request->caster;
+        result.origin = request->origin;
+        result.frame = request->frame;
+        result.input = request->input;
+        result.started = std::chrono::steady_clock::now();
+        {
+            TRACE_SCOPE("cast");
+            request->caster->castWithin(request->origin, m_bounds, result.output);
+        }
+
+        result.stats = takeCastStats();
+        result.finished = std::chrono::steady_clock::now();
+
+        m_published.fetch_add(1, std::memory_order_relaxed);
+        if (m_results.publish()) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        if (m_notify) {
+            m_notify();
+        }
+    }
+}
+
+void CastWorker::request(
+    Caster &caster, const Point &origin, uint64_t frame, std::chrono::steady_clock::time_point input
+) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_request.has_value()) {
+            m_superseded++;
+        }
+
+        m_request = Request{&caster, origin, frame, input};
+    }
+
+    m_wake.notify_one();
+}
+
+CastResult *CastWorker::latest() {
+    return m_results.consume();
+}
+
+CastWorkerStats CastWorker::stats() const {
+    CastWorkerStats stats;
+    stats.published = m_published.load(std::memory_order_relaxed);
+    stats.dropped = m_dropped.load(std::memory_order_relaxed);
+    stats.superseded = m_superseded;
+    return stats;
+}
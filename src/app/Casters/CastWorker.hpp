@@ -0,0 +1,99 @@
+#pragma once
+
+#include "pch.hpp"
+#include "Caster.hpp"
+#include "Core/TripleBuffer.hpp"
+#include "Profile/CastStats.hpp"
+
+
+struct CastResult {
+    Caster *caster = nullptr;
+    Point origin;
+
+    // The render frame the cast was requested on.
+    uint64_t frame = 0;
+
+    // When the input the cast responds to arrived, and when the cast started and finished.
+    std::chrono::steady_clock::time_point input;
+    std::chrono::steady_clock::time_point started;
+    std::chrono::steady_clock::time_point finished;
+
+    CastOutput output;
+
+    // The work done by the cast. Uploading is counted on the thread that uploads.
+    CastStats stats;
+};
+
+
+struct CastWorkerStats {
+    // Results handed to the render thread.
+    uint64_t published = 0;
+
+    // Results replaced by a newer one before the render thread took them.
+    uint64_t dropped = 0;
+
+    // Requests replaced by a newer one before the worker started them.
+    uint64_t superseded = 0;
+};
+
+
+/* ****** Cast Worker ******
+* Runs Caster::castWithin on its own thread so a slow cast does not hold up the frame.
+*
+* The render thread posts the newest light position with request and picks up finished
+*   vertices with latest, which never blocks. Only the newest request is kept and only the newest
+*   result is returned, so a worker that falls behind skips work instead of building a backlog.
+*
+* While a worker exists, the casters it is given must only be cast by the worker.
+*   Uploading and drawing them on the render thread is fine.
+*/
+class CastWorker {
+    struct Request {
+        Caster *caster;
+        Point origin;
+        uint64_t frame;
+        std::chrono::steady_clock::time_point input;
+    };
+
+    // The bounds must not change while the worker is alive.
+    const std::vector<LineSegment> &m_bounds;
+    TripleBuffer<CastResult> m_results;
+
+    // Called on the worker thread after each publish.
+    std::function<void()> m_notify;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::optional<Request> m_request;
+    bool m_running = true;
+
+    std::atomic<uint64_t> m_published{0};
+    std::atomic<uint64_t> m_dropped{0};
+    uint64_t m_superseded = 0;
+
+    // Declared last so the thread starts after everything it uses.
+    std::thread m_thread;
+
+    void run();
+
+public:
+    // notify is called from the worker thread whenever a result is published, e.g. to wake a sleeping event loop.
+    explicit CastWorker(const std::vector<LineSegment> &bounds, std::function<void()> notify = nullptr);
+
+    CastWorker(const CastWorker &other) = delete;
+
+    CastWorker &operator=(const CastWorker &other) = delete;
+
+    // Waits for the cast in progress, if any, to finish.
+    ~CastWorker();
+
+    void request(
+        Caster &caster, const Point &origin, uint64_t frame,
+        std::chrono::steady_clock::time_point input = std::chrono::steady_clock::now()
+    );
+
+    // The newest finished cast, or nullptr if there is nothing new. Valid until the next call.
+    CastResult *latest();
+
+    [[nodiscard]] CastWorkerStats stats() const;
+};
@@ -1,8 +1,192 @@
 #include "pch.hpp"
 #include "Caster.hpp"
+#include "Math/Predicates.hpp"
+#include "Profile/CastStats.hpp"
+#include "Profile/Trace.hpp"
+
+static constexpr float M_PI = 3.14159265358979323846f;
+static constexpr float M_TAU = M_PI * 2.0f;
+
+// How far the edge of a clipped light may stray inside the true circle, in pixels.
+static constexpr float CIRCLE_TOLERANCE = 0.25f;
+static constexpr uint32_t MIN_CIRCLE_SIDES = 12;
+static constexpr uint32_t MAX_CIRCLE_SIDES = 512;
+
+
+// The squared distance from point to the nearest point of the segment's bounding box.
+static float squaredBoxDistance(const Point &point, const LineSegment &segment) {
+    const float left = std::min(segment.a.x, segment.b.x);
+    const float right = std::max(segment.a.x, segment.b.x);
+    const float bottom = std::min(segment.a.y, segment.b.y);
+    const float top = std::max(segment.a.y, segment.b.y);
+
+    const float dx = std::max({left - point.x, point.x - right, 0.0f});
+    const float dy = std::max({bottom - point.y, point.y - top, 0.0f});
+    return dx * dx + dy * dy;
+}
+
+
+// Walls the light in with a polygon inscribed in the circle, with as few sides as the tolerance allows.
+//   Each side overlaps its neighbours slightly so no ray can slip out through a corner.
+static void appendCircle(const Point &center, float radius, std::vector<LineSegment> &bounds) {
+    const float step = 2.0f * std::acos(std::max(1.0f - CIRCLE_TOLERANCE / radius, -1.0f));
+    const auto sides = std::clamp(
+        static_cast<uint32_t>(std::ceil(M_TAU / step)), MIN_CIRCLE_SIDES, MAX_CIRCLE_SIDES
+    );
+
+    const float slice = M_TAU / static_cast<float>(sides);
+    const float overlap = slice * 0.001f;
+    for (uint32_t i = 0; i < sides; i++) {
+        const float start = static_cast<float>(i) * slice - overlap;
+        const float end = static_cast<float>(i + 1) * slice + overlap;
+        bounds.emplace_back(
+            center.x + radius * std::cos(start), center.y + radius * std::sin(start),
+            center.x + radius * std::cos(end), center.y + radius * std::sin(end)
+        );
+    }
+}
+
+// The distance from point to the nearest point of the segment.
+static float segmentDistance(const Point &point, const LineSegment &segment) {
+    const float ex = segment.b.x - segment.a.x;
+    const float ey = segment.b.y - segment.a.y;
+    const float wx = point.x - segment.a.x;
+    const float wy = point.y - segment.a.y;
+
+    const float squaredLength = ex * ex + ey * ey;
+    const float t = squaredLength > 0.0f ? std::clamp((wx * ex + wy * ey) / squaredLength, 0.0f, 1.0f) : 0.0f;
+    const float dx = wx - t * ex;
+    const float dy = wy - t * ey;
+    return std::sqrt(dx * dx + dy * dy);
+}
+
+// The segments a robust search must test, kept per thread since every caster's thread searches on its own.
+static const std::vector<uint32_t> &straddling(const Ray &ray, const std::vector<LineSegment> &bounds) {
+    thread_local std::vector<uint32_t> indices;
+    straddlingSegments(ray, bounds, indices);
+    return indices;
+}
+
+
+// SegmentOrder
+void SegmentOrder::sort(const Point &from, const std::vector<LineSegment> &bounds) {
+    origin = from;
+    keys.clear();
+    for (size_t i = 0; i < bounds.size(); i++) {
+        keys.emplace_back(segmentDistance(from, bounds[i]), static_cast<uint32_t>(i));
+    }
+
+    std::sort(keys.begin(), keys.end());
+
+    nearest.resize(keys.size());
+    indices.resize(keys.size());
+    for (size_t k = 0; k < keys.size(); k++) {
+        nearest[k] = keys[k].first;
+        indices[k] = keys[k].second;
+    }
+}
+
+
+// Caster
+void Caster::update(float x, float y) {
+    pos.x = x;
+    pos.y = y;
+}
+
+void Caster::look(const std::vector<LineSegment> &bounds) {
+    {
+        TRACE_SCOPE("cast");
+        castWithin(pos, bounds, m_output);
+    }
+    {
+        TRACE_SCOPE("upload");
+        upload(m_output);
+    }
+}
+
+void Caster::castWithin(const Point &origin, const std::vector<LineSegment> &bounds, CastOutput &output) {
+    const float limit = radius();
+    const Occluders *culling = m_occluders.load(std::memory_order_relaxed);
+    if (limit <= 0.0f || m_grid == nullptr) {
+        if (culling == nullptr) {
+            cast(origin, bounds, output);
+        } else {
+            culling->cull(origin, m_nearby);
+            cast(origin, m_nearby, output);
+        }
+
+        return;
+    }
+
+    m_grid->query(origin, limit, m_nearbyIndices);
+    m_nearby.clear();
+    for (uint32_t index : m_nearbyIndices) {
+        if (culling == nullptr || culling->faces(index, origin)) {
+            m_nearby.push_back(bounds[index]);
+        }
+    }
+
+    appendCircle(origin, limit, m_nearby);
+    cast(origin, m_nearby, output);
+}
+
+void Caster::draw() {
+    drawCall().execute();
+}
+
+void Caster::robust(bool enabled) {
+    m_robust.store(enabled, std::memory_order_relaxed);
+}
+
+bool Caster::robust() const {
+    return m_robust.load(std::memory_order_relaxed);
+}
+
+void Caster::trig(TrigPrecision precision) {
+    m_trig.store(precision, std::memory_order_relaxed);
+}
+
+TrigPrecision Caster::trig() const {
+    return m_trig.load(std::memory_order_relaxed);
+}
+
+void Caster::coherent(bool enabled) {
+    m_coherent.store(enabled, std::memory_order_relaxed);
+}
+
+bool Caster::coherent() const {
+    return m_coherent.load(std::memory_order_relaxed);
+}
+
+void Caster::sorted(bool enabled) {
+    m_sorted.store(enabled, std::memory_order_relaxed);
+}
+
+bool Caster::sorted() const {
+    return m_sorted.load(std::memory_order_relaxed);
+}
+
+void Caster::index(const SegmentGrid *grid) {
+    m_grid = grid;
+}
+
+void Caster::occluders(const Occluders *occluders) {
+    m_occluders.store(occluders, std::memory_order_relaxed);
+}
+
+void Caster::radius(float radius) {
+    m_radius.store(radius, std::memory_order_relaxed);
+}
+
+float Caster::radius() const {
+    return m_radius.load(std::memory_order_relaxed);
+}
+
 
 Point closestIntersection(const Ray &ray, std::vector<Point> intersections) {
     const unsigned int numIntersections = intersections.size();
+    castStats().resolved++;
+
     Point shortestPath = intersections[0];
 
     for (unsigned int i = 1; i < numIntersections; i++) {
@@ -19,11 +203,154 @@ Point closestIntersection(const Ray &ray, std::vector<Point> intersections) {
 
 void pushIntersections(
     const Ray &ray, const std::vector<LineSegment> &bounds,
-    std::vector<Point> &intersections
+    std::vector<Point> &intersections, bool robust
 ) {
-    for (const LineSegment &bound : bounds) {
-        if (auto intersection = ray.intersects(bound)) {
-            intersections.push_back(intersection.value());
+    const size_t before = intersections.size();
+    if (robust) {
+        for (uint32_t i : straddling(ray, bounds)) {
+            if (auto intersection = robustIntersection(ray, bounds[i])) {
+                intersections.push_back(intersection.value());
+            }
+        }
+    } else {
+        for (const LineSegment &bound : bounds) {
+            if (auto hit = intersection(ray, bound)) {
+                intersections.push_back(hit.value());
+            }
+        }
+    }
+
+    CastStats &stats = castStats();
+    stats.rays++;
+    stats.segmentTests += bounds.size();
+    stats.hits += intersections.size() - before;
+}
+
+Hit closestHit(const Ray &ray, const std::vector<LineSegment> &bounds, bool robust) {
+    // Compared squared, and only the winner's square root taken.
+    Hit closest{ray.pos};
+    uint64_t hits = 0;
+    const auto test = [&](size_t i, const std::optional<Point> &intersection) {
+        if (!intersection) {
+            return;
+        }
+
+        hits++;
+        const float distance = ray.pos.distanceTo(intersection.value());
+        if (closest.segment == -1 || distance < closest.distance) {
+            closest = {intersection.value(), distance, static_cast<int32_t>(i)};
+        }
+    };
+
+    if (robust) {
+        for (uint32_t i : straddling(ray, bounds)) {
+            test(i, robustIntersection(ray, bounds[i]));
+        }
+    } else {
+        for (size_t i = 0; i < bounds.size(); i++) {
+            test(i, intersection(ray, bounds[i]));
         }
     }
+
+    closest.distance = std::sqrt(closest.distance);
+
+    CastStats &stats = castStats();
+    stats.rays++;
+    stats.segmentTests += bounds.size();
+    stats.hits += hits;
+    stats.resolved += hits > 0;
+    return closest;
+}
+
+// Tests one segment for the pruning closestHit overloads, keeping closest with its distance squared.
+static void testSegment(
+    const Ray &ray, const std::vector<LineSegment> &bounds, size_t i, bool robust, Hit &closest, uint64_t &hits
+) {
+    const auto hit = robust ? robustIntersection(ray, bounds[i]) : intersection(ray, bounds[i]);
+    if (!hit) {
+        return;
+    }
+
+    hits++;
+    const float distance = ray.pos.distanceTo(hit.value());
+    if (closest.segment == -1 || distance < closest.distance) {
+        closest = {hit.value(), distance, static_cast<int32_t>(i)};
+    }
+}
+
+Hit closestHit(const Ray &ray, const std::vector<LineSegment> &bounds, bool robust, int32_t seed) {
+    // Squared until the end, like the box distances it is compared with.
+    Hit closest{ray.pos};
+    uint64_t tests = 0;
+    uint64_t hits = 0;
+    const auto test = [&](size_t i) {
+        tests++;
+        testSegment(ray, bounds, i, robust, closest, hits);
+    };
+
+    if (seed >= 0 && static_cast<size_t>(seed) < bounds.size()) {
+        test(static_cast<size_t>(seed));
+    }
+
+    for (size_t i = 0; i < bounds.size(); i++) {
+        if (static_cast<int32_t>(i) == seed) {
+            continue;
+        }
+
+        // Nothing on a segment can be nearer than its bounding box, so this only drops segments that cannot win.
+        if (closest.segment != -1 && squaredBoxDistance(ray.pos, bounds[i]) > closest.distance) {
+            continue;
+        }
+
+        test(i);
+    }
+
+    closest.distance = std::sqrt(closest.distance);
+
+    CastStats &stats = castStats();
+    stats.rays++;
+    stats.segmentTests += tests;
+    stats.pruned += bounds.size() - tests;
+    stats.hits += hits;
+    stats.resolved += hits > 0;
+    return closest;
+}
+
+Hit closestHit(
+    const Ray &ray, const std::vector<LineSegment> &bounds, bool robust, const SegmentOrder &order, int32_t seed
+) {
+    Hit closest{ray.pos};
+    uint64_t tests = 0;
+    uint64_t hits = 0;
+    if (seed >= 0 && static_cast<size_t>(seed) < bounds.size()) {
+        tests++;
+        testSegment(ray, bounds, static_cast<size_t>(seed), robust, closest, hits);
+    }
+
+    // A ray that starts away from the order's origin may come that much nearer to each segment.
+    const float slack = std::sqrt(ray.pos.distanceTo(order.origin)) + ORDER_SLACK;
+    for (size_t k = 0; k < order.indices.size(); k++) {
+        const float reach = order.nearest[k] - slack;
+        if (closest.segment != -1 && reach > 0.0f && reach * reach > closest.distance) {
+            break;
+        }
+
+        const uint32_t i = order.indices[k];
+        if (static_cast<int32_t>(i) == seed) {
+            continue;
+        }
+
+        tests++;
+        testSegment(ray, bounds, i, robust, closest, hits);
+    }
+
+    closest.distance = std::sqrt(closest.distance);
+
+    CastStats &stats = castStats();
+    stats.rays++;
+    stats.segmentTests += tests;
+    stats.pruned += bounds.size() - tests;
+    stats.hits += hits;
+    stats.resolved += hits > 0;
+    return closest;
 }
@@ -1,17 +1,155 @@
 #pragma once
 
 #include "pch.hpp"
+#include "Math/FastTrig.hpp"
 #include "Math/Geometrics.hpp"
+#include "Render/DrawCall.hpp"
+#include "Scene/Occluders.hpp"
+#include "Scene/SegmentGrid.hpp"
 
+// Pixels a sorted search looks past its best hit, so rounding in the two distances never stops it short.
+constexpr float ORDER_SLACK = 0.001f;
+
+/* ****** Segment Order ******
+* The segments sorted by how near they come to a point. A search for a ray's nearest hit can walk them in that
+*   order and stop at the first segment further away than its best hit, since every segment after it is further
+*   still. Costs a sort per point, but needs nothing kept between frames, so it suits a light that moves every frame.
+*/
+struct SegmentOrder {
+    Point origin;
+
+    // nearest[k] is how near the segment at bounds[indices[k]] comes to origin, in ascending order.
+    std::vector<float> nearest;
+    std::vector<uint32_t> indices;
+
+    // Scratch for sort, kept to save allocating it every cast.
+    std::vector<std::pair<float, uint32_t>> keys;
+
+    void sort(const Point &from, const std::vector<LineSegment> &bounds);
+};
+
+
+// What cast hands to upload. A caster that packs two parts into vertices, like the penumbra's umbra fan and wedges,
+//   records in split how many of the floats belong to the first. The rest leave it alone.
+struct CastOutput {
+    std::vector<float> vertices;
+    size_t split = 0;
+};
+
+
+/* ****** Caster ******
+* Casting is split in two so it can run off the render thread:
+*   cast   - computes the light's vertices on the CPU. Never touches GL, so it may run on any thread,
+*            but a caster must not cast on two threads at once.
+*   upload - sends vertices produced by cast to the caster's buffers. Must run on the GL thread.
+*
+* update and look do both on the calling thread.
+*
+* With a grid and a radius set, castWithin only casts against the segments within the radius of the light,
+*   and the light is clipped to that circle, so a small light costs the same in a small level as in a huge one.
+*   With occluders set, it also skips the polygon edges that face away from the light.
+*
+* In coherent mode, casters that test one ray at a time start each ray on the segment the ray before it hit.
+*   Neighbouring rays usually land on the same wall, so that gives a near bound at once, and every segment
+*   further away than it is skipped untested.
+*
+* In sorted mode, those casters sort the segments by distance from the light at the start of each cast instead,
+*   and every ray's search stops at the first segment further away than its best hit.
+*/
 class __declspec(novtable) Caster {
+protected:
+    Point pos;
+    CastOutput m_output;
+
+    // Read by whichever thread casts, so these may be changed while a worker is busy.
+    std::atomic<bool> m_robust{false};
+    std::atomic<TrigPrecision> m_trig{TrigPrecision::Libm};
+    std::atomic<bool> m_coherent{false};
+    std::atomic<bool> m_sorted{false};
+    std::atomic<float> m_radius{0.0f};
+    std::atomic<const Occluders *> m_occluders{nullptr};
+
+    const SegmentGrid *m_grid = nullptr;
+    std::vector<uint32_t> m_nearbyIndices;
+    std::vector<LineSegment> m_nearby;
+
+    // The segments of the current cast in order of distance, in sorted mode.
+    SegmentOrder m_order;
+
 public:
-    virtual void update(float x, float y) = 0;
+    void update(float x, float y);
+
+    void look(const std::vector<LineSegment> &bounds);
+
+    virtual void cast(const Point &origin, const std::vector<LineSegment> &bounds, CastOutput &output) = 0;
+
+    // cast, limited to the radius when one is set. bounds must be the segments the grid was built from.
+    void castWithin(const Point &origin, const std::vector<LineSegment> &bounds, CastOutput &output);
+
+    virtual void upload(const CastOutput &output) = 0;
 
-    virtual void look(const std::vector<LineSegment> &bounds) = 0;
+    // The draw that renders the caster's current results.
+    virtual DrawCall drawCall() = 0;
 
-    virtual void draw() = 0;
+    void draw();
+
+    // Use exact predicates for the hit tests, so rays through shared endpoints never leak. Slower.
+    void robust(bool enabled);
+
+    [[nodiscard]] bool robust() const;
+
+    // Which sine, cosine and arc tangent the caster aims its rays with.
+    void trig(TrigPrecision precision);
+
+    [[nodiscard]] TrigPrecision trig() const;
+
+    // Seed each ray's search with the previous ray's hit.
+    void coherent(bool enabled);
+
+    [[nodiscard]] bool coherent() const;
+
+    // Walk each ray's search from the nearest segment out, stopping once the rest are all further than its hit.
+    void sorted(bool enabled);
+
+    [[nodiscard]] bool sorted() const;
+
+    // The grid must outlive the caster, or be replaced first. Unlike the settings above, it is not atomic, so set
+    //   it before any thread casts.
+    void index(const SegmentGrid *grid);
+
+    // The occluders bounds was built from, for back face culling. nullptr casts against every segment.
+    void occluders(const Occluders *occluders);
+
+    // The furthest the light reaches. 0 is unlimited.
+    void radius(float radius);
+
+    [[nodiscard]] float radius() const;
+};
+
+// The nearest wall a ray hits, distance pixels from the ray's origin. segment is -1 when it hits nothing,
+//   and point is then the ray's origin.
+struct Hit {
+    Point point;
+    float distance = 0.0f;
+    int32_t segment = -1;
 };
 
 Point closestIntersection(const Ray &ray, std::vector<Point> intersections);
 
-void pushIntersections(const Ray &ray, const std::vector<LineSegment> &bounds, std::vector<Point> &intersections);
+// pushIntersections and closestIntersection in one pass, keeping which segment was hit.
+Hit closestHit(const Ray &ray, const std::vector<LineSegment> &bounds, bool robust = false);
+
+// closestHit, testing the segment at seed first and then skipping every segment whose bounding box lies further
+//   than the nearest hit so far. seed is usually the previous ray's hit; -1 starts without one.
+Hit closestHit(const Ray &ray, const std::vector<LineSegment> &bounds, bool robust, int32_t seed);
+
+// closestHit, walking the segments in order and stopping at the first that is further than the nearest hit so far.
+//   order must be sorted over bounds. The ray may start away from its origin, at some cost in how soon it stops.
+//   seed is tested first as in the coherent overload, or -1 for none.
+Hit closestHit(
+    const Ray &ray, const std::vector<LineSegment> &bounds, bool robust, const SegmentOrder &order, int32_t seed
+);
+
+void pushIntersections(
+    const Ray &ray, const std::vector<LineSegment> &bounds, std::vector<Point> &intersections, bool robust = false
+);
@@ -8,37 +8,37 @@
 
 
 class LineEndPointCaster : public Caster {
-    Point pos;
     lwvl::VertexArray vao;
     lwvl::ArrayBuffer vbo;
     lwvl::ElementBuffer ebo;
     unsigned int currentRays;
+    unsigned int drawnRays;
     std::vector<Point> intersections;
 
 public:
     explicit LineEndPointCaster(unsigned int numBounds);
 
-    void update(float x, float y) final;
+    void cast(const Point &origin, const std::vector<LineSegment> &bounds, CastOutput &output) final;
 
-    void look(const std::vector<LineSegment> &bounds) final;
+    void upload(const CastOutput &output) final;
 
-    void draw() final;
+    DrawCall drawCall() final;
 };
 
 
 class FilledEndPointCaster : public Caster {
-    Point pos;
     lwvl::VertexArray vao;
     lwvl::ArrayBuffer vbo;
     unsigned int currentRays;
+    unsigned int drawnRays;
     std::vector<Point> intersections;
 
 public:
     explicit FilledEndPointCaster(unsigned int numBounds);
 
-    void update(float x, float y) final;
+    void cast(const Point &origin, const std::vector<LineSegment> &bounds, CastOutput &output) final;
 
-    void look(const std::vector<LineSegment> &bounds) final;
+    void upload(const CastOutput &output) final;
 
-    void draw() final;
+    DrawCall drawCall() final;
 };
@@ -0,0 +1,652 @@
+#include "pch.hpp"
+#include "EndPoints.hpp"
+#include "Profile/CastStats.hpp"
+
+static constexpr float M_PI = 3.14159265358979323846f;
+static constexpr float M_TAU = M_PI * 2.0f;
+static constexpr float EPSILON = 0.0001f;
+
+// Rays traced together. Eight floats fill one AVX register, or two SSE ones.
+static constexpr size_t packetWidth = 8;
+
+// How far a segment end may lie outside a packet's wedge and still be tested, relative to its distance.
+static constexpr float WEDGE_SLACK = 0.0001f;
+
+// What each packet of rays shares: the edges of the wedge it spans and how far its rays reach so far.
+//   Kept in separate arrays so every packet can be checked against a segment in one pass.
+struct Packets {
+    std::vector<float> firstX;
+    std::vector<float> firstY;
+    std::vector<float> lastX;
+    std::vector<float> lastY;
+    std::vector<float> furthest;
+
+    explicit Packets(size_t count) :
+        firstX(count), firstY(count), lastX(count), lastY(count), furthest(count) {}
+};
+
+static bool same(const Point &a, const Point &b) {
+    return a.x == b.x && a.y == b.y;
+}
+
+static float side(const Point &origin, const Point &towards, const Point &point) {
+    return (towards.x - origin.x) * (point.y - origin.y) - (towards.y - origin.y) * (point.x - origin.x);
+}
+
+// An angle to cast at and how far the ray can reach. The rays around a silhouette also keep which corner they
+//   belong to, and whether they pass before it, at it or after it.
+struct Heading {
+    float angle;
+    float reach;
+    int32_t corner = -1;
+    int32_t role = 0;
+};
+
+// Wall endpoints as offsets from the light, kept in separate arrays so their angles are found in one batch. Each
+//   also keeps the far ends of the walls before and after it, or itself where a chain starts or ends there.
+struct Corners {
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<uint8_t> silhouette;
+    std::vector<Point> point;
+    std::vector<Point> before;
+    std::vector<Point> after;
+
+    void add(const Point &origin, const Point &corner, bool isSilhouette, const Point &from, const Point &to) {
+        x.push_back(corner.x - origin.x);
+        y.push_back(corner.y - origin.y);
+        silhouette.push_back(isSilhouette);
+        point.push_back(corner);
+        before.push_back(from);
+        after.push_back(to);
+    }
+};
+
+// How far point is from the line through a and b.
+static float lineDistance(const Point &point, const Point &a, const Point &b) {
+    return std::abs(side(a, b, point)) / std::sqrt((b.x - a.x) * (b.x - a.x) + (b.y - a.y) * (b.y - a.y));
+}
+
+// Whether nothing can be seen past corner from anywhere within radius of origin, i.e. the walls before and after it
+//   lie on either side of the ray to it. From origin that holds in the two opposite angles the walls' lines make
+//   at corner, so it holds across the disk when the disk keeps clear of both lines too.
+static bool blocked(const Point &origin, const Point &before, const Point &corner, const Point &after, float radius) {
+    const float sideBefore = side(origin, corner, before);
+    const float sideAfter = side(origin, corner, after);
+    if (!(sideBefore < 0.0f && sideAfter > 0.0f) && !(sideBefore > 0.0f && sideAfter < 0.0f)) {
+        return false;
+    }
+
+    return radius == 0.0f
+        || (lineDistance(origin, corner, before) >= radius && lineDistance(origin, corner, after) >= radius);
+}
+
+// The bits of a point, with -0 and 0 alike, so points can be looked up by exact equality.
+static uint64_t pointKey(const Point &point) {
+    uint32_t x, y;
+    const float px = point.x + 0.0f;
+    const float py = point.y + 0.0f;
+    std::memcpy(&x, &px, sizeof(x));
+    std::memcpy(&y, &py, sizeof(y));
+    return static_cast<uint64_t>(x) << 32 | y;
+}
+
+// The angles to cast at, three around each wall endpoint. Where two walls in a row share an endpoint it is only
+//   cast at once, and when the walls lie on either side of the ray to it nothing can be seen past it, so one ray
+//   is enough. Back face culling leaves the lit side of each polygon as such chains. A chain that ends where an
+//   earlier one starts, like a whole polygon or one that wraps past its first edge, shares that corner too.
+//
+// For a disk light of radius around origin, a corner looks a little further round from each point of the disk, so
+//   silhouettes get one more ray to each side, at the widest angle the corner takes from the rest of the disk,
+//   and a corner only gets a single ray when it is blocked from the whole disk.
+static void endpointHeadings(
+    const Point &origin, float radius, const std::vector<LineSegment> &bounds, TrigPrecision precision,
+    Corners &corners, std::vector<Heading> &headings
+) {
+
+    // The corner each chain starts at, and the chain's first wall.
+    std::unordered_map<uint64_t, std::pair<size_t, size_t>> starts;
+    for (size_t i = 0; i < bounds.size(); i++) {
+        const LineSegment &line = bounds[i];
+        if (i == 0 || !same(bounds[i - 1].b, line.a)) {
+            starts.try_emplace(pointKey(line.a), corners.x.size(), i);
+            corners.add(origin, line.a, true, line.a, line.b);
+        }
+
+        if (i + 1 < bounds.size() && same(bounds[i + 1].a, line.b)) {
+            const Point &next = bounds[i + 1].b;
+            corners.add(origin, line.b, !blocked(origin, line.a, line.b, next, radius), line.a, next);
+            continue;
+        }
+
+        const auto start = starts.find(pointKey(line.b));
+        if (start != starts.end()) {
+            const auto [corner, first] = start->second;
+            corners.silhouette[corner] = !blocked(origin, line.a, line.b, bounds[first].b, radius);
+            corners.before[corner] = line.a;
+            starts.erase(start);
+        } else {
+            corners.add(origin, line.b, true, line.a, line.b);
+        }
+    }
+
+    const size_t count = corners.x.size();
+    std::vector<float> angles(count);
+    arcTangent(precision, corners.y.data(), corners.x.data(), angles.data(), count);
+
+    headings.clear();
+    headings.reserve(count * (radius > 0.0f ? 5 : 3));
+    constexpr float unlimited = std::numeric_limits<float>::infinity();
+    for (size_t i = 0; i < count; i++) {
+        const float angle = angles[i];
+        const float distance = std::sqrt(corners.x[i] * corners.x[i] + corners.y[i] * corners.y[i]);
+        if (!corners.silhouette[i]) {
+            // Rounding can let the ray slip between the two walls, but it can never see past the corner. Rays from
+            //   the rest of a disk do not pass through the corner, so they are left to find the walls.
+            headings.push_back({angle, radius > 0.0f ? unlimited : distance});
+            continue;
+        }
+
+        headings.insert(
+            headings.end(),
+            {
+                {angle - EPSILON, unlimited, static_cast<int32_t>(i), 0},
+                {angle, unlimited, static_cast<int32_t>(i), 1},
+                {angle + EPSILON, unlimited, static_cast<int32_t>(i), 2}
+            }
+        );
+        if (radius > 0.0f) {
+            const float spread = std::asin(std::min(radius / distance, 1.0f));
+            headings.insert(headings.end(), {{angle - spread, unlimited}, {angle + spread, unlimited}});
+        }
+    }
+}
+
+// Unit directions for the headings, in the same order.
+static void aim(
+    const std::vector<Heading> &headings, TrigPrecision precision, std::vector<float> &dirX, std::vector<float> &dirY
+) {
+    std::vector<float> angles(headings.size());
+    for (size_t i = 0; i < headings.size(); i++) {
+        angles[i] = headings[i].angle;
+    }
+
+    dirX.resize(headings.size());
+    dirY.resize(headings.size());
+    sinCos(precision, angles.data(), dirY.data(), dirX.data(), angles.size());
+}
+
+// Wraps the headings into [0, tau) and puts them in angle order, so neighbouring rays point almost the same way.
+static void sortHeadings(std::vector<Heading> &headings) {
+    for (Heading &heading : headings) {
+        // Headings are less than a turn outside [0, tau), so one turn either way is enough to wrap them.
+        if (heading.angle < 0.0f) {
+            heading.angle += M_TAU;
+        } else if (heading.angle >= M_TAU) {
+            heading.angle -= M_TAU;
+        }
+    }
+
+    std::sort(
+        headings.begin(), headings.end(),
+        [](const Heading &a, const Heading &b) { return std::tie(a.angle, a.reach) < std::tie(b.angle, b.reach); }
+    );
+}
+
+// Where a ray stops: at the nearest hit within its reach, at its reach when it hits nothing nearer,
+//   or at the origin when it is unlimited and hits nothing.
+static Point stop(const Point &origin, float dirX, float dirY, float distance) {
+    if (distance == std::numeric_limits<float>::infinity()) {
+        return origin;
+    }
+
+    return {origin.x + distance * dirX, origin.y + distance * dirY};
+}
+
+// Casts each heading on its own, with the robust predicates when exact, writing where the rays stop from vertices[2]
+//   on. When coherent, each ray's search starts on the segment the ray before it hit. Unless order is nullptr, each
+//   search walks it and stops at the first segment beyond the ray's hit.
+static void traceEach(
+    const Point &origin, const std::vector<LineSegment> &bounds, const std::vector<Heading> &headings,
+    const std::vector<float> &dirX, const std::vector<float> &dirY, bool exact, bool coherent,
+    const SegmentOrder *order, std::vector<Point> &intersections, std::vector<float> &vertices
+) {
+    Ray ray(origin.x, origin.y, 0.0f);
+    intersections.reserve(bounds.size());
+    int32_t previous = -1;
+    for (size_t i = 0; i < headings.size(); i++) {
+        ray.dir.x = dirX[i];
+        ray.dir.y = dirY[i];
+
+        float distance = headings[i].reach;
+        if (coherent || order != nullptr) {
+            const Hit hit = order != nullptr ? closestHit(ray, bounds, exact, *order, coherent ? previous : -1)
+                                             : closestHit(ray, bounds, exact, previous);
+            previous = hit.segment;
+            if (hit.segment != -1) {
+                distance = std::min(distance, hit.distance);
+            }
+        } else {
+            pushIntersections(ray, bounds, intersections, exact);
+            if (!intersections.empty()) {
+                const Point nearest = closestIntersection(ray, intersections);
+                distance = std::min(distance, (nearest.x - origin.x) * ray.dir.x + (nearest.y - origin.y) * ray.dir.y);
+            }
+        }
+
+        const Point end = stop(origin, ray.dir.x, ray.dir.y, distance);
+        vertices[(i + 1) * 2 + 0] = end.x;
+        vertices[(i + 1) * 2 + 1] = end.y;
+
+        intersections.clear();
+    }
+}
+
+// Tests one segment against the rays from..to, keeping each ray's nearest hit and counting its hits.
+//   Rays that already stop nearer are masked off by the comparison rather than skipped.
+static void intersectLanes(
+    const LineSegment &segment, const Point &origin, const float *dx, const float *dy, float *nearest,
+    uint32_t *found, size_t from, size_t to
+) {
+    const float ex = segment.b.x - segment.a.x;
+    const float ey = segment.b.y - segment.a.y;
+    const float ax = segment.a.x - origin.x;
+    const float ay = segment.a.y - origin.y;
+    const float across = ex * ay - ey * ax;
+
+    for (size_t i = from; i < to; i++) {
+        const float den = ex * dy[i] - ey * dx[i];
+        const float inverse = 1.0f / den;
+        const float t = (ay * dx[i] - ax * dy[i]) * inverse;
+        const float u = across * inverse;
+
+        // & rather than && so there is no branch to stop the loop from vectorizing.
+        const bool hit = (den != 0.0f) & (t >= 0.0f) & (t <= 1.0f) & (u >= 0.0f);
+        const bool closer = hit & (u < nearest[i]);
+        found[i] += hit;
+        nearest[i] = closer ? u : nearest[i];
+    }
+}
+
+// Casts sorted headings in packets of neighbouring rays, writing where the rays stop from vertices[2] on.
+//   Each segment is first checked against every packet, and skipped for a whole packet when it lies outside the
+//   wedge the packet spans, or when every ray in the packet already stops nearer than it comes. Only the rays of
+//   the packets left are tested against it. Unless order is nullptr the segments are taken in it.
+static void tracePackets(
+    const Point &origin, const std::vector<LineSegment> &bounds, const std::vector<Heading> &headings,
+    const std::vector<float> &dirX, const std::vector<float> &dirY, const SegmentOrder *order,
+    std::vector<float> &vertices
+) {
+    const size_t numRays = headings.size();
+    if (numRays == 0) {
+        return;
+    }
+
+    // The rays side by side, a packet after another. Padding repeats the last ray, so every packet is full.
+    const size_t numPackets = (numRays + packetWidth - 1) / packetWidth;
+    const size_t padded = numPackets * packetWidth;
+    std::vector<float> laneX(padded);
+    std::vector<float> laneY(padded);
+    std::vector<float> nearest(padded);
+    std::vector<uint32_t> found(padded, 0);
+    for (size_t i = 0; i < padded; i++) {
+        const size_t ray = std::min(i, numRays - 1);
+        laneX[i] = dirX[ray];
+        laneY[i] = dirY[ray];
+        nearest[i] = headings[ray].reach;
+    }
+
+    // Up to half a turn the wedge from a packet's first ray to its last is convex, so a segment with both ends
+    //   outside the same side of it misses every ray in between. Wider packets get no edges, which culls nothing.
+    Packets packets(numPackets);
+    for (size_t p = 0; p < numPackets; p++) {
+        const size_t first = p * packetWidth;
+        const size_t last = std::min(first + packetWidth, numRays) - 1;
+        if (headings[last].angle - headings[first].angle <= M_PI) {
+            packets.firstX[p] = laneX[first];
+            packets.firstY[p] = laneY[first];
+            packets.lastX[p] = laneX[last];
+            packets.lastY[p] = laneY[last];
+        }
+
+        packets.furthest[p] = *std::max_element(nearest.data() + first, nearest.data() + first + packetWidth);
+    }
+
+    // In order the segments come nearest first, so once one is further than every packet reaches, so are the rest.
+    //   How far they reach is gathered while checking the packets against the segment before, which can only
+    //   overestimate it.
+    uint64_t tests = 0;
+    uint64_t pruned = 0;
+    float reach = std::numeric_limits<float>::infinity();
+    std::vector<uint8_t> reached(numPackets);
+    for (size_t k = 0; k < bounds.size(); k++) {
+        if (order != nullptr && order->nearest[k] - ORDER_SLACK > reach) {
+            pruned = (bounds.size() - k) * numRays;
+            break;
+        }
+
+        const LineSegment &segment = bounds[order != nullptr ? order->indices[k] : k];
+        const float ax = segment.a.x - origin.x;
+        const float ay = segment.a.y - origin.y;
+        const float bx = segment.b.x - origin.x;
+        const float by = segment.b.y - origin.y;
+        const float ex = bx - ax;
+        const float ey = by - ay;
+
+        // Rays aimed right at a corner must not lose it to rounding, so the wedges are widened slightly.
+        const float slackA = WEDGE_SLACK * (std::abs(ax) + std::abs(ay));
+        const float slackB = WEDGE_SLACK * (std::abs(bx) + std::abs(by));
+
+        const float length = ex * ex + ey * ey;
+        const float along = length > 0.0f ? std::clamp(-(ax * ex + ay * ey) / length, 0.0f, 1.0f) : 0.0f;
+        const float closestX = ax + along * ex;
+        const float closestY = ay + along * ey;
+        const float closest = closestX * closestX + closestY * closestY;
+
+        reach = 0.0f;
+        for (size_t p = 0; p < numPackets; p++) {
+            const bool beforeFirst = (packets.firstX[p] * ay - packets.firstY[p] * ax < -slackA)
+                & (packets.firstX[p] * by - packets.firstY[p] * bx < -slackB);
+            const bool pastLast = (packets.lastX[p] * ay - packets.lastY[p] * ax > slackA)
+                & (packets.lastX[p] * by - packets.lastY[p] * bx > slackB);
+            const bool near = closest <= packets.furthest[p] * packets.furthest[p];
+            reached[p] = !(beforeFirst | pastLast) & near;
+            reach = packets.furthest[p] > reach ? packets.furthest[p] : reach;
+        }
+
+        // Neighbouring packets the segment reaches are tested in one run, which keeps the loop over rays long.
+        for (size_t start = 0; start < numPackets;) {
+            if (!reached[start]) {
+                start++;
+                continue;
+            }
+
+            size_t end = start + 1;
+            while (end < numPackets && reached[end]) {
+                end++;
+            }
+
+            const size_t from = start * packetWidth;
+            const size_t to = end * packetWidth;
+            tests += std::min(to, numRays) - from;
+            intersectLanes(segment, origin, laneX.data(), laneY.data(), nearest.data(), found.data(), from, to);
+            for (size_t p = start; p < end; p++) {
+                const float *lanes = nearest.data() + p * packetWidth;
+                packets.furthest[p] = *std::max_element(lanes, lanes + packetWidth);
+            }
+
+            start = end;
+        }
+    }
+
+    uint64_t hits = 0;
+    uint64_t resolved = 0;
+    for (size_t i = 0; i < numRays; i++) {
+        hits += found[i];
+        resolved += found[i] > 0;
+        const Point end = stop(origin, laneX[i], laneY[i], nearest[i]);
+        vertices[(i + 1) * 2 + 0] = end.x;
+        vertices[(i + 1) * 2 + 1] = end.y;
+    }
+
+    CastStats &stats = castStats();
+    stats.rays += numRays;
+    stats.segmentTests += tests;
+    stats.hits += hits;
+    stats.resolved += resolved;
+    stats.pruned += pruned;
+}
+
+
+
+// Casts sorted headings from every sample at once, along the same directions, writing one fan per sample: the sample,
+//   where each ray stops, and the first ray again to close it. The packets work as in tracePackets, with their
+//   wedges and reach widened by radius so they hold for every sample. For each ray a segment reaches, everything
+//   that only depends on the direction is worked out once, and the samples are tested against it in one loop.
+static void traceSamples(
+    const Point &center, float radius, const float *sampleX, const float *sampleY, uint32_t samples,
+    const std::vector<LineSegment> &bounds, const std::vector<Heading> &headings, const std::vector<float> &dirX,
+    const std::vector<float> &dirY, const SegmentOrder *order, std::vector<float> &vertices
+) {
+    const size_t numRays = headings.size();
+    const size_t fanSize = numRays + 2;
+
+    // Each ray's samples side by side, a ray after another.
+    std::vector<float> nearest(numRays * samples);
+    std::vector<uint32_t> found(numRays * samples, 0);
+    for (size_t i = 0; i < numRays; i++) {
+        std::fill_n(nearest.data() + i * samples, samples, headings[i].reach);
+    }
+
+    const size_t numPackets = (numRays + packetWidth - 1) / packetWidth;
+    Packets packets(numPackets);
+    for (size_t p = 0; p < numPackets; p++) {
+        const size_t first = p * packetWidth;
+        const size_t last = std::min(first + packetWidth, numRays) - 1;
+        if (headings[last].angle - headings[first].angle <= M_PI) {
+            packets.firstX[p] = dirX[first];
+            packets.firstY[p] = dirY[first];
+            packets.lastX[p] = dirX[last];
+            packets.lastY[p] = dirY[last];
+        }
+
+        const float *lanes = nearest.data() + first * samples;
+        packets.furthest[p] = *std::max_element(lanes, lanes + (last + 1 - first) * samples);
+    }
+
+    // Stops early in order like tracePackets, with the segments up to radius nearer some of the samples.
+    uint64_t tests = 0;
+    uint64_t pruned = 0;
+    float reach = std::numeric_limits<float>::infinity();
+    std::vector<uint8_t> reached(numPackets);
+    for (size_t k = 0; k < bounds.size(); k++) {
+        if (order != nullptr && order->nearest[k] - radius - ORDER_SLACK > reach) {
+            pruned = (bounds.size() - k) * numRays * samples;
+            break;
+        }
+
+        const LineSegment &segment = bounds[order != nullptr ? order->indices[k] : k];
+        const float ax = segment.a.x - center.x;
+        const float ay = segment.a.y - center.y;
+        const float bx = segment.b.x - center.x;
+        const float by = segment.b.y - center.y;
+        const float ex = bx - ax;
+        const float ey = by - ay;
+
+        // A sample's rays run parallel to the center's, at most radius to the side of them.
+        const float slackA = WEDGE_SLACK * (std::abs(ax) + std::abs(ay)) + radius;
+        const float slackB = WEDGE_SLACK * (std::abs(bx) + std::abs(by)) + radius;
+
+        const float length = ex * ex + ey * ey;
+        const float along = length > 0.0f ? std::clamp(-(ax * ex + ay * ey) / length, 0.0f, 1.0f) : 0.0f;
+        const float closestX = ax + along * ex;
+        const float closestY = ay + along * ey;
+        const float closest = std::max(std::sqrt(closestX * closestX + closestY * closestY) - radius, 0.0f);
+
+        reach = 0.0f;
+        for (size_t p = 0; p < numPackets; p++) {
+            const bool beforeFirst = (packets.firstX[p] * ay - packets.firstY[p] * ax < -slackA)
+                & (packets.firstX[p] * by - packets.firstY[p] * bx < -slackB);
+            const bool pastLast = (packets.lastX[p] * ay - packets.lastY[p] * ax > slackA)
+                & (packets.lastX[p] * by - packets.lastY[p] * bx > slackB);
+            reached[p] = !(beforeFirst | pastLast) & (closest <= packets.furthest[p]);
+            reach = packets.furthest[p] > reach ? packets.furthest[p] : reach;
+        }
+
+        for (size_t p = 0; p < numPackets; p++) {
+            if (!reached[p]) {
+                continue;
+            }
+
+            const size_t first = p * packetWidth;
+            const size_t last = std::min(first + packetWidth, numRays);
+            for (size_t i = first; i < last; i++) {
+                const float dx = dirX[i];
+                const float dy = dirY[i];
+                const float den = ex * dy - ey * dx;
+                if (den == 0.0f) {
+                    continue;
+                }
+
+                // Ray::intersects with the sample independent parts hoisted. u is the distance along the ray.
+                const float inverse = 1.0f / den;
+                float *lanes = nearest.data() + i * samples;
+                uint32_t *hits = found.data() + i * samples;
+                for (uint32_t j = 0; j < samples; j++) {
+                    const float wx = segment.a.x - sampleX[j];
+                    const float wy = segment.a.y - sampleY[j];
+                    const float t = (wy * dx - wx * dy) * inverse;
+                    const float u = (ex * wy - ey * wx) * inverse;
+
+                    const bool hit = (t >= 0.0f) & (t <= 1.0f) & (u >= 0.0f);
+                    const bool closer = hit & (u < lanes[j]);
+                    hits[j] += hit;
+                    lanes[j] = closer ? u : lanes[j];
+                }
+            }
+
+            tests += (last - first) * samples;
+            packets.furthest[p] = *std::max_element(nearest.data() + first * samples, nearest.data() + last * samples);
+        }
+    }
+
+    uint64_t hits = 0;
+    uint64_t resolved = 0;
+    vertices.resize(2 * fanSize * samples);
+    for (uint32_t k = 0; k < samples; k++) {
+        float *fan = vertices.data() + 2 * fanSize * k;
+        fan[0] = sampleX[k];
+        fan[1] = sampleY[k];
+        for (size_t i = 0; i < numRays; i++) {
+            const size_t lane = i * samples + k;
+            hits += found[lane];
+            resolved += found[lane] > 0;
+            const Point end = stop({sampleX[k], sampleY[k]}, dirX[i], dirY[i], nearest[lane]);
+            fan[2 * (i + 1) + 0] = end.x;
+            fan[2 * (i + 1) + 1] = end.y;
+        }
+
+        fan[2 * (fanSize - 1) + 0] = fan[numRays > 0 ? 2 : 0];
+        fan[2 * (fanSize - 1) + 1] = fan[numRays > 0 ? 3 : 1];
+    }
+
+    CastStats &stats = castStats();
+    stats.rays += numRays * samples;
+    stats.segmentTests += tests;
+    stats.hits += hits;
+    stats.resolved += resolved;
+    stats.pruned += pruned;
+}
+
+uint32_t traceEndPoints(
+    const Point &origin, const std::vector<LineSegment> &bounds, TrigPrecision precision, bool exact, bool coherent,
+    const SegmentOrder *order, std::vector<Point> &intersections, std::vector<float> &vertices,
+    std::vector<Silhouette> *silhouettes
+) {
+    Corners corners;
+    std::vector<Heading> headings;
+    std::vector<float> dirX;
+    std::vector<float> dirY;
+    endpointHeadings(origin, 0.0f, bounds, precision, corners, headings);
+    sortHeadings(headings);
+    aim(headings, precision, dirX, dirY);
+
+    const auto numRays = static_cast<uint32_t>(headings.size());
+    if (silhouettes != nullptr) {
+        // Where each silhouette's rays ended up in angle order. A corner can show up twice when two chains end
+        //   there, so its rays are found by what they were cast at rather than by being next to each other.
+        std::vector<std::array<uint32_t, 3>> rays(corners.x.size());
+        for (uint32_t ray = 0; ray < numRays; ray++) {
+            const Heading &heading = headings[ray];
+            if (heading.corner >= 0) {
+                rays[heading.corner][heading.role] = ray;
+            }
+        }
+
+        silhouettes->clear();
+        for (size_t corner = 0; corner < corners.x.size(); corner++) {
+            if (!corners.silhouette[corner]) {
+                continue;
+            }
+
+            const Point &point = corners.point[corner];
+            const auto [before, at, after] = rays[corner];
+            for (const Point &wall : {corners.before[corner], corners.after[corner]}) {
+                if (!same(wall, point)) {
+                    silhouettes->push_back({point, wall, before, at, after});
+                }
+            }
+        }
+    }
+
+    vertices.resize(2 * (numRays + 1));
+    vertices[0] = origin.x;
+    vertices[1] = origin.y;
+
+    // The packets only run in float, so hit tests in another scalar go one ray at a time as well.
+    if (exact || !floatHits) {
+        traceEach(origin, bounds, headings, dirX, dirY, exact, coherent, order, intersections, vertices);
+    } else {
+        tracePackets(origin, bounds, headings, dirX, dirY, order, vertices);
+    }
+
+    return numRays;
+}
+
+uint32_t traceDiskEndPoints(
+    const Point &center, float radius, const float *offsetX, const float *offsetY, uint32_t samples,
+    const std::vector<LineSegment> &bounds, TrigPrecision precision, bool exact, bool coherent,
+    const SegmentOrder *order, std::vector<Point> &intersections, std::vector<float> &vertices
+) {
+    Corners corners;
+    std::vector<Heading> headings;
+    std::vector<float> dirX;
+    std::vector<float> dirY;
+    endpointHeadings(center, radius, bounds, precision, corners, headings);
+    sortHeadings(headings);
+    aim(headings, precision, dirX, dirY);
+
+    const auto numRays = static_cast<uint32_t>(headings.size());
+    const uint32_t fanSize = numRays + 2;
+    std::vector<float> sampleX(samples);
+    std::vector<float> sampleY(samples);
+    for (uint32_t k = 0; k < samples; k++) {
+        sampleX[k] = center.x + offsetX[k];
+        sampleY[k] = center.y + offsetY[k];
+    }
+
+    // The samples are only batched in float, so exact hit tests, or ones in another scalar, go one ray at a time.
+    //   A light without any size casts the same fan from every sample, which the packets do faster on their own.
+    vertices.resize(2 * fanSize * samples);
+    if (!exact && floatHits && radius == 0.0f) {
+        vertices[0] = center.x;
+        vertices[1] = center.y;
+        tracePackets(center, bounds, headings, dirX, dirY, order, vertices);
+        vertices[2 * (fanSize - 1) + 0] = vertices[numRays > 0 ? 2 : 0];
+        vertices[2 * (fanSize - 1) + 1] = vertices[numRays > 0 ? 3 : 1];
+        for (uint32_t k = 1; k < samples; k++) {
+            std::copy(vertices.begin(), vertices.begin() + 2 * fanSize, vertices.begin() + 2 * fanSize * k);
+        }
+        return fanSize;
+    }
+
+    if (!exact && floatHits) {
+        traceSamples(
+            center, radius, sampleX.data(), sampleY.data(), samples, bounds, headings, dirX, dirY, order, vertices
+        );
+        return fanSize;
+    }
+
+    std::vector<float> fan(2 * fanSize);
+    for (uint32_t k = 0; k < samples; k++) {
+        const Point sample{sampleX[k], sampleY[k]};
+        fan[0] = sample.x;
+        fan[1] = sample.y;
+        traceEach(sample, bounds, headings, dirX, dirY, exact, coherent, order, intersections, fan);
+        fan[2 * (fanSize - 1) + 0] = fan[numRays > 0 ? 2 : 0];
+        fan[2 * (fanSize - 1) + 1] = fan[numRays > 0 ? 3 : 1];
+        std::copy(fan.begin(), fan.end(), vertices.begin() + 2 * fanSize * k);
+    }
+
+    return fanSize;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "pch.hpp"
+#include "Caster.hpp"
+#include "Math/FastTrig.hpp"
+#include "Math/Geometrics.hpp"
+
+
+// A wall endpoint that can be seen past, the far end of one wall meeting there, and which of the rays are the
+//   three cast around it. Where two walls meet at one there is one for each.
+struct Silhouette {
+    Point corner;
+    Point wall;
+    uint32_t before;
+    uint32_t at;
+    uint32_t after;
+};
+
+// Casts three rays around each wall endpoint seen from origin, or one where nothing can be seen past it, in angle
+//   order. vertices is resized to origin followed by where each ray stops, and the number of rays is returned.
+//   The rays are traced one at a time when exact or when hit tests are not float, and in packets otherwise, and
+//   unless order is nullptr either way goes through the segments nearest first and stops once they are out of
+//   reach. Unless silhouettes is nullptr, it gets the endpoints that have three rays.
+uint32_t traceEndPoints(
+    const Point &origin, const std::vector<LineSegment> &bounds, TrigPrecision precision, bool exact, bool coherent,
+    const SegmentOrder *order, std::vector<Point> &intersections, std::vector<float> &vertices,
+    std::vector<Silhouette> *silhouettes = nullptr
+);
+
+// The same rays for a disk light of radius around center, cast from each of samples points offset from it. Every
+//   sample casts along the same directions, the ones at each corner as seen from center and one to each side at
+//   the widest angle it takes from the rest of the disk, so the fans can be traced together. vertices gets one fan
+//   per sample, the sample, where each ray stops and the first ray again to close it, and the vertices in a fan are
+//   returned.
+uint32_t traceDiskEndPoints(
+    const Point &center, float radius, const float *offsetX, const float *offsetY, uint32_t samples,
+    const std::vector<LineSegment> &bounds, TrigPrecision precision, bool exact, bool coherent,
+    const SegmentOrder *order, std::vector<Point> &intersections, std::vector<float> &vertices
+);
@@ -0,0 +1,155 @@
+#include "pch.hpp"
+#include "PenumbraCaster.hpp"
+#include "Profile/CastStats.hpp"
+
+// How far short of a wall endpoint its ray may stop and still count as reaching it, in pixels.
+static constexpr float REACH_TOLERANCE = 0.5f;
+
+// Wedges shorter than this would not cover a visible pixel.
+static constexpr float MIN_WEDGE_LENGTH = 1.0f;
+
+static constexpr uint32_t wedgeStride = 7;
+
+
+static float length(float x, float y) {
+    return std::sqrt(x * x + y * y);
+}
+
+
+PenumbraCaster::PenumbraCaster(float lightRadius) : m_lightRadius(lightRadius) {
+    vbo.usage(lwvl::Usage::Dynamic);
+    vbo.construct<float>(nullptr, 0);
+    vao.attribute(vbo, 2, GL_FLOAT, 2 * sizeof(float), 0);
+
+    wedgeVbo.usage(lwvl::Usage::Dynamic);
+    wedgeVbo.construct<float>(nullptr, 0);
+    wedgeVao.attribute(wedgeVbo, 2, GL_FLOAT, wedgeStride * sizeof(float), 0);
+    wedgeVao.attribute(wedgeVbo, 4, GL_FLOAT, wedgeStride * sizeof(float), 2 * sizeof(float));
+    wedgeVao.attribute(wedgeVbo, 1, GL_FLOAT, wedgeStride * sizeof(float), 6 * sizeof(float));
+}
+
+void PenumbraCaster::cast(const Point &origin, const std::vector<LineSegment> &bounds, CastOutput &output) {
+    std::vector<float> &vertices = output.vertices;
+
+    const bool exact = robust();
+    const float radius = m_lightRadius;
+
+    const SegmentOrder *order = nullptr;
+    if (sorted()) {
+        m_order.sort(origin, bounds);
+        order = &m_order;
+    }
+
+    // The umbra fan, in angle order and closed on its first ray, or on the origin without any.
+    const uint32_t numRays = traceEndPoints(
+        origin, bounds, trig(), exact, coherent(), order, intersections, vertices, &m_silhouettes
+    );
+    const size_t first = numRays > 0 ? 2 : 0;
+    vertices.insert(vertices.end(), {vertices[first], vertices[first + 1]});
+
+    const auto reach = [&](uint32_t ray) {
+        const float *stop = vertices.data() + 2 * (ray + 1);
+        return length(stop[0] - origin.x, stop[1] - origin.y);
+    };
+
+    std::vector<float> outer;
+    std::vector<float> inner;
+    for (const Silhouette &silhouette : m_silhouettes) {
+        const Point &endpoint = silhouette.corner;
+        const Point &other = silhouette.wall;
+        const float ux = endpoint.x - origin.x;
+        const float uy = endpoint.y - origin.y;
+
+        const float before = reach(silhouette.before);
+        const float at = reach(silhouette.at);
+        const float after = reach(silhouette.after);
+
+        // The wall turns left of the ray when this is positive, leaving the clockwise side open.
+        const float turn = ux * (other.y - endpoint.y) - uy * (other.x - endpoint.x);
+        const float distance = length(ux, uy);
+        const float past = (turn > 0.0f ? before : after) - distance;
+        if (distance <= radius || at < distance - REACH_TOLERANCE || past < MIN_WEDGE_LENGTH) {
+            continue;
+        }
+
+        // The wedge's sides are the lines through the endpoint tangent to the light disk, the ray from the center
+        //   turned either way by the angle whose sine is radius / distance.
+        const float centerX = ux / distance;
+        const float centerY = uy / distance;
+        const float sine = radius / distance;
+        const float cosine = std::sqrt(1.0f - sine * sine);
+        const float wallLength = length(other.x - endpoint.x, other.y - endpoint.y);
+        const float wallX = (other.x - endpoint.x) / wallLength;
+        const float wallY = (other.y - endpoint.y) / wallLength;
+
+        // The ray through the endpoint from the center of the light splits the wedge. The half on the open side
+        //   is lit in the umbra fan and darkens it, the half on the wall's side is in shadow and lightens it.
+        const float leftX = centerX * cosine - centerY * sine;
+        const float leftY = centerX * sine + centerY * cosine;
+        const float rightX = centerX * cosine + centerY * sine;
+        const float rightY = centerY * cosine - centerX * sine;
+        const float left[2] = {endpoint.x + past * leftX, endpoint.y + past * leftY};
+        const float center[2] = {endpoint.x + past * centerX, endpoint.y + past * centerY};
+        const float right[2] = {endpoint.x + past * rightX, endpoint.y + past * rightY};
+
+        const float *const open = turn > 0.0f ? right : left;
+        const float *const closed = turn > 0.0f ? left : right;
+        const float *const halves[2][2] = {{open, center}, {center, closed}};
+        for (int half = 0; half < 2; half++) {
+            std::vector<float> &wedges = half == 0 ? outer : inner;
+            wedges.insert(wedges.end(), {endpoint.x, endpoint.y, endpoint.x, endpoint.y, wallX, wallY, 1.0f});
+            for (const float *corner : halves[half]) {
+                wedges.insert(wedges.end(), {corner[0], corner[1], endpoint.x, endpoint.y, wallX, wallY, 1.0f});
+            }
+        }
+    }
+
+    // Every wedge has one half of each, so the outer and inner halves split the rest evenly.
+    output.split = vertices.size();
+    vertices.insert(vertices.end(), outer.begin(), outer.end());
+    vertices.insert(vertices.end(), inner.begin(), inner.end());
+}
+
+void PenumbraCaster::upload(const CastOutput &output) {
+    const std::vector<float> &vertices = output.vertices;
+    const auto fan = vertices.begin();
+    const auto wedges = fan + static_cast<ptrdiff_t>(output.split);
+    const size_t fanFloats = output.split;
+    const auto wedgeFloats = static_cast<size_t>(vertices.end() - wedges);
+    m_fanVertices = static_cast<uint32_t>(fanFloats / 2);
+    m_wedgeVertices = static_cast<uint32_t>(wedgeFloats / wedgeStride);
+
+    // Grow the buffers when needed, and never shrink them.
+    if (fanFloats > m_fanCapacity) {
+        vbo.construct<float>(nullptr, fanFloats);
+        m_fanCapacity = fanFloats;
+    }
+
+    if (wedgeFloats > m_wedgeCapacity) {
+        wedgeVbo.construct<float>(nullptr, wedgeFloats);
+        m_wedgeCapacity = wedgeFloats;
+    }
+
+    if (fanFloats > 0) {
+        vbo.update(fan, wedges);
+    }
+
+    if (wedgeFloats > 0) {
+        wedgeVbo.update(wedges, vertices.end());
+    }
+
+    castStats().bytesUploaded += vertices.size() * sizeof(float);
+}
+
+DrawCall PenumbraCaster::drawCall() {
+    return DrawCall::arrays(vao, lwvl::PrimitiveMode::TriangleFan, static_cast<int32_t>(m_fanVertices));
+}
+
+DrawCall PenumbraCaster::outerWedgeDrawCall() {
+    return DrawCall::arrays(wedgeVao, lwvl::PrimitiveMode::Triangles, static_cast<int32_t>(m_wedgeVertices / 2));
+}
+
+DrawCall PenumbraCaster::innerWedgeDrawCall() {
+    const auto half = static_cast<int32_t>(m_wedgeVertices / 2);
+    return DrawCall::arrays(wedgeVao, lwvl::PrimitiveMode::Triangles, half, half);
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "pch.hpp"
+#include "Caster.hpp"
+#include "EndPoints.hpp"
+#include "Math/Geometrics.hpp"
+#include "VertexArray.hpp"
+#include "Buffer.hpp"
+
+
+/* ****** Penumbra Caster ******
+* Soft shadows from a disk light at about the cost of one hard shadow cast.
+*
+* The umbra is the same filled fan FilledEndPointCaster casts from the center of the light, and traceEndPoints
+*   reports the silhouettes it finds on the way, the endpoints that get three rays. One is visible when the ray at
+*   it stops there, and every visible one gets a penumbra wedge, a triangle from the endpoint out to where the ray
+*   just past it on the side away from the wall lands, spanning the lines tangent to the light disk. The light
+*   shader works out how much of the disk each wedge fragment can see past the wall and scales the light by it.
+*
+* The ray from the center of the light through the endpoint splits each wedge in two. The outer half lies in the lit
+*   fan and is drawn darkening, the inner half lies in the hard shadow and is drawn lightening, so where wedges overlap
+*   the darkest and brightest coverage win instead of whichever was drawn last.
+*
+* cast packs it all into one array, the fan's positions, then the outer halves, then the inner halves, and splits
+*   the output after the fan.
+*/
+class PenumbraCaster : public Caster {
+    lwvl::VertexArray vao;
+    lwvl::ArrayBuffer vbo;
+
+    // Position, silhouette vertex, direction its wall leaves in, and a flag telling the light shader it is a wedge.
+    lwvl::VertexArray wedgeVao;
+    lwvl::ArrayBuffer wedgeVbo;
+
+    float m_lightRadius;
+    uint32_t m_fanVertices = 0;
+    uint32_t m_wedgeVertices = 0;
+    size_t m_fanCapacity = 0;
+    size_t m_wedgeCapacity = 0;
+
+    std::vector<Silhouette> m_silhouettes;
+    std::vector<Point> intersections;
+
+public:
+    explicit PenumbraCaster(float lightRadius);
+
+    void cast(const Point &origin, const std::vector<LineSegment> &bounds, CastOutput &output) final;
+
+    void upload(const CastOutput &output) final;
+
+    // The umbra.
+    DrawCall drawCall() final;
+
+    // Drawn after the umbra with the same program, the outer halves with BlendMode::Darken and the inner halves
+    //   with BlendMode::Lighten, so together they replace the hard edge.
+    DrawCall outerWedgeDrawCall();
+
+    DrawCall innerWedgeDrawCall();
+};
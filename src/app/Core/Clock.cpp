@@ -0,0 +1,55 @@
+#include "pch.hpp"
+#include "Clock.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <ctime>
+#endif
+
+
+double processSeconds() {
+#ifdef _WIN32
+    // std::clock measures wall time with MSVC, so ask the kernel directly.
+    FILETIME creation, exit, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user)) {
+        return 0.0;
+    }
+
+    const auto ticks = [](const FILETIME &time) {
+        return (static_cast<uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+    };
+
+    // FILETIME counts in 100 nanosecond intervals.
+    return static_cast<double>(ticks(kernel) + ticks(user)) * 1e-7;
+#else
+    return static_cast<double>(std::clock()) / CLOCKS_PER_SEC;
+#endif
+}
+
+
+void UsageMeter::start() {
+    if (!m_running) {
+        m_cpuStart = processSeconds();
+        m_wallStart = std::chrono::steady_clock::now();
+        m_running = true;
+    }
+}
+
+void UsageMeter::stop() {
+    if (m_running) {
+        m_cpu += processSeconds() - m_cpuStart;
+        m_wall += std::chrono::duration<double>(std::chrono::steady_clock::now() - m_wallStart).count();
+        m_running = false;
+    }
+}
+
+double UsageMeter::usage() const {
+    return m_wall > 0.0 ? m_cpu / m_wall : 0.0;
+}
+
+double UsageMeter::seconds() const {
+    return m_wall;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "pch.hpp"
+
+
+// CPU time used by every thread of this process, in seconds.
+double processSeconds();
+
+
+// Accumulates CPU and wall time between start and stop to report average CPU usage.
+class UsageMeter {
+    double m_cpu = 0.0;
+    double m_wall = 0.0;
+
+    double m_cpuStart = 0.0;
+    std::chrono::steady_clock::time_point m_wallStart;
+    bool m_running = false;
+
+public:
+    void start();
+
+    void stop();
+
+    // CPU time as a fraction of one core over every measured interval.
+    [[nodiscard]] double usage() const;
+
+    [[nodiscard]] double seconds() const;
+};
@@ -2,4 +2,7 @@
 #include "Event.hpp"
 
 
-Event::Event(Type type, AnonymousEvent event) : type(type), event(event) {}
+Event::Event() : type(Type::UserEvent), event(static_cast<UserEvent *>(nullptr)) {}
+
+Event::Event(Type type, AnonymousEvent event) :
+    type(type), event(event), time(std::chrono::steady_clock::now()) {}
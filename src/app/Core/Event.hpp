@@ -44,5 +44,11 @@ public:
     Type type;
     AnonymousEvent event;
 
+    // When the window system reported the event.
+    std::chrono::steady_clock::time_point time;
+
+    // An empty user event, so events can be stored in preallocated queues.
+    Event();
+
     Event(Type type, AnonymousEvent event);
 };
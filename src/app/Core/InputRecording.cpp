@@ -0,0 +1,196 @@
+#include "pch.hpp"
+#include "InputRecording.hpp"
+
+static constexpr char magic[4] = {'R', 'C', 'I', 'N'};
+static constexpr uint32_t version = 1;
+
+
+template<typename T>
+static void write(std::ofstream &file, const T &value) {
+    file.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template<typename T>
+static bool read(std::ifstream &file, T &value) {
+    return static_cast<bool>(file.read(reinterpret_cast<char *>(&value), sizeof(T)));
+}
+
+
+static void writeEvent(std::ofstream &file, const Event &event) {
+    write(file, static_cast<uint8_t>(event.type));
+    if (const auto *keyboard = std::get_if<KeyboardEvent>(&event.event)) {
+        write<int32_t>(file, keyboard->key);
+        write<int32_t>(file, keyboard->scancode);
+        write<int32_t>(file, keyboard->mods);
+    } else if (const auto *text = std::get_if<TextEvent>(&event.event)) {
+        write<uint32_t>(file, text->codepoint);
+    } else if (const auto *motion = std::get_if<MouseMotionEvent>(&event.event)) {
+        write(file, motion->xpos);
+        write(file, motion->ypos);
+    } else if (const auto *button = std::get_if<MouseButtonEvent>(&event.event)) {
+        write<int32_t>(file, button->button);
+        write<int32_t>(file, button->mods);
+    }
+}
+
+static bool readEvent(std::ifstream &file, Event &event) {
+    uint8_t type;
+    if (!read(file, type)) {
+        return false;
+    }
+
+    event.type = static_cast<Event::Type>(type);
+    switch (event.type) {
+        case Event::Type::KeyPress:
+        case Event::Type::KeyRelease:
+        case Event::Type::KeyRepeat: {
+            int32_t key, scancode, mods;
+            if (!(read(file, key) && read(file, scancode) && read(file, mods))) {
+                return false;
+            }
+
+            event.event = KeyboardEvent{key, scancode, mods};
+            return true;
+        }
+        case Event::Type::TextInput: {
+            uint32_t codepoint;
+            if (!read(file, codepoint)) {
+                return false;
+            }
+
+            event.event = TextEvent{codepoint};
+            return true;
+        }
+        case Event::Type::MouseMotion: {
+            double xpos, ypos;
+            if (!(read(file, xpos) && read(file, ypos))) {
+                return false;
+            }
+
+            event.event = MouseMotionEvent{xpos, ypos};
+            return true;
+        }
+        case Event::Type::MouseDown:
+        case Event::Type::MouseUp: {
+            int32_t button, mods;
+            if (!(read(file, button) && read(file, mods))) {
+                return false;
+            }
+
+            event.event = MouseButtonEvent{button, mods};
+            return true;
+        }
+        default:return false;
+    }
+}
+
+
+/* ****** Input Recorder ****** */
+InputRecorder::InputRecorder(const std::string &path) : m_file(path, std::ios::binary) {
+    if (!m_file.is_open()) {
+        throw std::exception("Could not open input recording for writing.");
+    }
+
+    m_file.write(magic, sizeof(magic));
+    write(m_file, version);
+}
+
+void InputRecorder::event(const Event &event) {
+    if (event.type != Event::Type::UserEvent) {
+        m_frame.events.push_back(event);
+    }
+}
+
+void InputRecorder::cursor(double x, double y) {
+    m_frame.cursorX = x;
+    m_frame.cursorY = y;
+}
+
+void InputRecorder::endFrame() {
+    const size_t count = std::min<size_t>(m_frame.events.size(), UINT16_MAX);
+    write(m_file, m_frame.cursorX);
+    write(m_file, m_frame.cursorY);
+    write(m_file, static_cast<uint16_t>(count));
+    for (size_t i = 0; i < count; i++) {
+        writeEvent(m_file, m_frame.events[i]);
+    }
+
+    // The cursor carries over so frames that did not sample it replay the last position.
+    m_frame.events.clear();
+    m_frames++;
+}
+
+uint64_t InputRecorder::frames() const {
+    return m_frames;
+}
+
+
+/* ****** Input Replay ****** */
+InputReplay::InputReplay(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::exception("Could not open input recording.");
+    }
+
+    char header[sizeof(magic)];
+    uint32_t fileVersion;
+    if (!file.read(header, sizeof(header)) || !std::equal(header, header + sizeof(header), magic)
+        || !read(file, fileVersion) || fileVersion != version) {
+        throw std::exception("Not a supported input recording.");
+    }
+
+    // A truncated final frame, e.g. from a crash while recording, is dropped.
+    RecordedFrame frame;
+    uint16_t count;
+    while (read(file, frame.cursorX) && read(file, frame.cursorY) && read(file, count)) {
+        frame.events.resize(count);
+        bool complete = true;
+        for (Event &event : frame.events) {
+            complete = complete && readEvent(file, event);
+        }
+
+        if (!complete) {
+            break;
+        }
+
+        m_frames.push_back(frame);
+    }
+}
+
+bool InputReplay::advance() {
+    if (m_started) {
+        m_frame++;
+    }
+
+    m_started = true;
+    m_event = 0;
+    return m_frame < m_frames.size();
+}
+
+std::optional<Event> InputReplay::pollEvent() {
+    if (m_frame >= m_frames.size() || m_event >= m_frames[m_frame].events.size()) {
+        return std::nullopt;
+    }
+
+    // Recorded times belong to the recording process, so events are stamped as they are replayed.
+    Event event = m_frames[m_frame].events[m_event++];
+    event.time = std::chrono::steady_clock::now();
+    return event;
+}
+
+std::pair<double, double> InputReplay::cursor() const {
+    if (m_frames.empty()) {
+        return {0.0, 0.0};
+    }
+
+    const RecordedFrame &frame = m_frames[std::min(m_frame, m_frames.size() - 1)];
+    return {frame.cursorX, frame.cursorY};
+}
+
+size_t InputReplay::frame() const {
+    return m_frame;
+}
+
+size_t InputReplay::frames() const {
+    return m_frames.size();
+}
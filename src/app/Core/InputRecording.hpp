@@ -0,0 +1,72 @@
+#pragma once
+
+#include "pch.hpp"
+#include "Event.hpp"
+
+
+// Everything the application read from the window on one iteration of its loop.
+struct RecordedFrame {
+    double cursorX = 0.0;
+    double cursorY = 0.0;
+    std::vector<Event> events;
+};
+
+
+/* ****** Input Recorder ******
+* Writes the events and cursor samples of every frame to a compact binary file.
+*
+* File layout, little endian:
+*   header - "RCIN", uint32 version
+*   frames - float64 cursor x, float64 cursor y, uint16 event count, then each event as
+*            uint8 type followed by its payload as written by writeEvent.
+* User events point into the recording process, so they are not recorded.
+*/
+class InputRecorder {
+    std::ofstream m_file;
+    RecordedFrame m_frame;
+    uint64_t m_frames = 0;
+
+public:
+    explicit InputRecorder(const std::string &path);
+
+    void event(const Event &event);
+
+    void cursor(double x, double y);
+
+    // Write the current frame and start the next one.
+    void endFrame();
+
+    [[nodiscard]] uint64_t frames() const;
+};
+
+
+/* ****** Input Replay ******
+* Plays a recording back one frame per loop iteration, regardless of how long the frames take.
+*
+* Usage:
+*   while (replay.advance()) {
+*       while (std::optional<Event> event = replay.pollEvent()) { ... }
+*       const auto[x, y] = replay.cursor();
+*   }
+*/
+class InputReplay {
+    std::vector<RecordedFrame> m_frames;
+    size_t m_frame = 0;
+    size_t m_event = 0;
+    bool m_started = false;
+
+public:
+    explicit InputReplay(const std::string &path);
+
+    // Move to the next frame. Returns false once every frame has been played.
+    bool advance();
+
+    // The events of the current frame, in recorded order.
+    std::optional<Event> pollEvent();
+
+    [[nodiscard]] std::pair<double, double> cursor() const;
+
+    [[nodiscard]] size_t frame() const;
+
+    [[nodiscard]] size_t frames() const;
+};
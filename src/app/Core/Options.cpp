@@ -0,0 +1,103 @@
+#include "pch.hpp"
+#include "Options.hpp"
+
+
+Options Options::parse(int argc, char **argv) {
+    Options options;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string_view argument = argv[i];
+
+        // Any scene option selects a generated scene, with defaults for the rest.
+        const auto scene = [&]() -> SceneSpec & {
+            if (!options.scene.has_value()) {
+                options.scene.emplace();
+            }
+
+            return options.scene.value();
+        };
+
+        const auto value = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                throw std::exception("Missing value for command line option.");
+            }
+
+            return argv[++i];
+        };
+
+        if (argument == "--record") {
+            options.record = value();
+        } else if (argument == "--replay") {
+            options.replay = value();
+        } else if (argument == "--timings") {
+            options.timings = value();
+        } else if (argument == "--headless") {
+            options.headless = true;
+        } else if (argument == "--frames") {
+            options.frames = std::stoull(value());
+        } else if (argument == "--bench") {
+            options.bench = true;
+        } else if (argument == "--check-trig") {
+            options.checkTrig = true;
+        } else if (argument == "--screenshot") {
+            options.screenshot = value();
+        } else if (argument == "--robust") {
+            options.robust = true;
+        } else if (argument == "--radius") {
+            options.radius = std::stof(value());
+        } else if (argument == "--fast-trig") {
+            options.fastTrig = true;
+        } else if (argument == "--rays") {
+            options.rays = static_cast<uint32_t>(std::stoul(value()));
+        } else if (argument == "--adaptive") {
+            options.adaptive = true;
+        } else if (argument == "--no-cull") {
+            options.cull = false;
+        } else if (argument == "--coherent") {
+            options.coherent = true;
+        } else if (argument == "--sorted") {
+            options.sorted = true;
+        } else if (argument == "--samples") {
+            options.samples = static_cast<uint32_t>(std::stoul(value()));
+        } else if (argument == "--scene") {
+            scene().kind = parseSceneKind(value());
+        } else if (argument == "--seed") {
+            scene().seed = std::stoull(value());
+        } else if (argument == "--segments") {
+            scene().segments = std::stoull(value());
+        } else {
+            usage(std::cerr);
+            throw std::exception("Unknown command line option.");
+        }
+    }
+
+    if (!options.replay.empty() && options.timings.empty()) {
+        options.timings = "timings.csv";
+    }
+
+    return options;
+}
+
+void Options::usage(std::ostream &stream) {
+    stream << "Usage: ray-casting [options]\n"
+              "  --record <file>   Record input to file.\n"
+              "  --replay <file>   Replay input from file as fast as possible.\n"
+              "  --timings <file>  Write per frame timings as CSV.\n"
+              "  --headless        Render offscreen in a hidden window.\n"
+              "  --frames <n>      Exit after n frames.\n"
+              "  --bench           Run unthrottled and print frame time percentiles.\n"
+              "  --check-trig      Check the polynomial trig error bounds and exit, failing if exceeded.\n"
+              "  --screenshot <f>  Write the last frame to f as a PPM image.\n"
+              "  --robust          Use exact predicates for every hit test.\n"
+              "  --radius <px>     Limit the light to a radius, casting only against nearby walls.\n"
+              "  --fast-trig       Aim rays with polynomial sin, cos and atan2 instead of libm.\n"
+              "  --rays <n>        Cast n evenly spaced rays in the angle modes.\n"
+              "  --adaptive        Refine the angle casters' rays around corners.\n"
+              "  --no-cull         Cast against the back faces of polygons too.\n"
+              "  --coherent        Seed each ray's search with the previous ray's hit.\n"
+              "  --sorted          Search each ray's walls nearest first, stopping past its hit.\n"
+              "  --samples <n>     Sample the area light at n points, up to 32.\n"
+              "  --scene <kind>    Generate a maze, soup, city or polygon scene.\n"
+              "  --seed <n>        Seed for the generated scene.\n"
+              "  --segments <n>    About how many segments the generated scene has.\n";
+}
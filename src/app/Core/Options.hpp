@@ -0,0 +1,67 @@
+#pragma once
+
+#include "pch.hpp"
+#include "Scene/SceneGenerator.hpp"
+
+
+// Command line options. Paths are empty when the option was not given.
+struct Options {
+    // Write the input of every frame to this file.
+    std::string record;
+
+    // Play input back from this file instead of the window, one recorded frame per frame.
+    std::string replay;
+
+    // Write per frame timings as CSV. Defaults to timings.csv when replaying.
+    std::string timings;
+
+    // Render into an offscreen framebuffer of a hidden window.
+    bool headless = false;
+
+    // Exit after this many presented frames. 0 runs until the window is closed.
+    uint64_t frames = 0;
+
+    // Run unthrottled, moving the light along a fixed path unless replaying, and print frame time percentiles.
+    bool bench = false;
+
+    // Check the polynomial trig functions against their documented error bounds and exit without opening a window.
+    bool checkTrig = false;
+
+    // Write the last frame to this file as a binary PPM.
+    std::string screenshot;
+
+    // Start every caster in robust mode.
+    bool robust = false;
+
+    // Limit the light to this radius in pixels. 0 is unlimited.
+    float radius = 0.0f;
+
+    // Start every caster on the polynomial trig functions.
+    bool fastTrig = false;
+
+    // Rays in one sweep of the angle casters.
+    uint32_t rays = 64;
+
+    // Start the angle casters refining their sweep around corners.
+    bool adaptive = false;
+
+    // Skip polygon edges facing away from the light.
+    bool cull = true;
+
+    // Start each ray cast on its own from the previous ray's hit.
+    bool coherent = false;
+
+    // Start each ray cast on its own searching the segments nearest the light first.
+    bool sorted = false;
+
+    // Points sampled on the disk of the area light.
+    uint32_t samples = 8;
+
+    // A generated scene to use instead of the built in one. Its area is filled in by the application.
+    std::optional<SceneSpec> scene;
+
+    // Throws on unknown or incomplete options.
+    static Options parse(int argc, char **argv);
+
+    static void usage(std::ostream &stream);
+};
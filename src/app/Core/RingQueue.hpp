@@ -0,0 +1,71 @@
+#pragma once
+
+#include "pch.hpp"
+
+
+/* ****** Ring Queue ******
+* A fixed capacity, single producer, single consumer FIFO.
+* One thread may push while another pops without locking, and nothing is allocated after construction.
+*
+* The producer only writes the tail and the consumer only writes the head, so each side
+*   publishes with a release store and observes the other side with an acquire load.
+*/
+template<typename T, size_t capacity>
+class RingQueue {
+    static_assert(capacity != 0 && (capacity & (capacity - 1)) == 0, "RingQueue capacity must be a power of two.");
+    static constexpr size_t wrap = capacity - 1;
+
+    std::array<T, capacity> m_items{};
+
+    // Keep the indices on separate cache lines so the two threads do not contend.
+    alignas(64) std::atomic<size_t> m_head{0};
+    alignas(64) std::atomic<size_t> m_tail{0};
+
+public:
+    // Producer only. Returns false without modifying the queue when it is full.
+    bool push(const T &item) {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) == capacity) {
+            return false;
+        }
+
+        m_items[tail & wrap] = item;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only. The oldest item, or nullptr when empty. Valid until the next pop.
+    const T *peek() const {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+
+        return &m_items[head & wrap];
+    }
+
+    // Consumer only.
+    std::optional<T> pop() {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire)) {
+            return std::nullopt;
+        }
+
+        T item = m_items[head & wrap];
+        m_head.store(head + 1, std::memory_order_release);
+        return item;
+    }
+
+    // Approximate when called while the other thread is active.
+    [[nodiscard]] size_t size() const {
+        return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] bool empty() const {
+        return size() == 0;
+    }
+
+    [[nodiscard]] static constexpr size_t max() {
+        return capacity;
+    }
+};
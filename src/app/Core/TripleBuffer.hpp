@@ -0,0 +1,53 @@
+#pragma once
+
+#include "pch.hpp"
+
+
+/* ****** Triple Buffer ******
+* Hands the latest value from one writer thread to one reader thread without locking or waiting.
+*
+* The writer fills the back slot and publishes it, the reader takes whatever was published most recently.
+*   The two sides only meet at the middle slot, which is swapped atomically along with a flag saying
+*   whether it holds a value the reader has not seen yet.
+*/
+template<typename T>
+class TripleBuffer {
+    static constexpr uint8_t indexMask = 0b011;
+    static constexpr uint8_t freshBit = 0b100;
+
+    std::array<T, 3> m_slots{};
+
+    // Writer only.
+    uint8_t m_back = 0;
+
+    // Shared. The index of the middle slot and the fresh bit.
+    std::atomic<uint8_t> m_middle{1};
+
+    // Reader only.
+    uint8_t m_front = 2;
+
+public:
+    // Writer only. The slot to fill before the next publish.
+    T &back() {
+        return m_slots[m_back];
+    }
+
+    // Writer only. Returns true if the previously published value was never read.
+    bool publish() {
+        const uint8_t previous = m_middle.exchange(m_back | freshBit, std::memory_order_acq_rel);
+        m_back = previous & indexMask;
+        return (previous & freshBit) != 0;
+    }
+
+    // Reader only. The newest published value, or nullptr if nothing was published since the last call.
+    //   The value stays valid until the next call.
+    T *consume() {
+        if ((m_middle.load(std::memory_order_relaxed) & freshBit) == 0) {
+            return nullptr;
+        }
+
+        const uint8_t previous = m_middle.exchange(m_front, std::memory_order_acq_rel);
+        m_front = previous & indexMask;
+        return &m_slots[m_front];
+    }
+};
@@ -40,6 +40,7 @@ GLFWwindow *Window::create(const Config &config, const char *title) {
     glfwWindowHint(GLFW_SAMPLES, config.samples);
 
     glfwWindowHint(GLFW_RESIZABLE, config.resizable ? GLFW_TRUE : GLFW_FALSE);
+    glfwWindowHint(GLFW_VISIBLE, config.visible ? GLFW_TRUE : GLFW_FALSE);
     glfwWindowHint(GLFW_SCALE_TO_MONITOR, true);
     glfwWindowHint(GLFW_REFRESH_RATE, 60);
 
@@ -68,8 +69,6 @@ GLFWwindow *Window::create(const Config &config, const char *title) {
 
 Window::Window(const Config &config, const char *title) :
     m_title(title), m_window(create(config, title)), m_config(config) {
-    m_events.reserve(eventStackCapacity);
-
     glfwSetWindowUserPointer(m_window, this);
     glfwSwapInterval(1);
 
@@ -77,15 +76,11 @@ Window::Window(const Config &config, const char *title) :
         m_window, [](GLFWwindow *window, int key, int scancode, int action, int mods) {
             Window *state = Window::getState(window);
             switch (action) {
-                case GLFW_PRESS:state->m_events.emplace_back(Event::Type::KeyPress, KeyboardEvent{key, scancode, mods});
+                case GLFW_PRESS:state->pushEvent({Event::Type::KeyPress, KeyboardEvent{key, scancode, mods}});
                     return;
-                case GLFW_RELEASE:
-                    state->m_events
-                         .emplace_back(Event::Type::KeyRelease, KeyboardEvent{key, scancode, mods});
+                case GLFW_RELEASE:state->pushEvent({Event::Type::KeyRelease, KeyboardEvent{key, scancode, mods}});
                     return;
-                case GLFW_REPEAT:
-                    state->m_events
-                         .emplace_back(Event::Type::KeyRepeat, KeyboardEvent{key, scancode, mods});
+                case GLFW_REPEAT:state->pushEvent({Event::Type::KeyRepeat, KeyboardEvent{key, scancode, mods}});
                     return;
                 default:return;
             }
@@ -95,7 +90,7 @@ Window::Window(const Config &config, const char *title) :
     glfwSetCursorPosCallback(
         m_window, [](GLFWwindow *window, double xpos, double ypos) {
             Window *state = Window::getState(window);
-            state->m_events.emplace_back(Event::Type::MouseMotion, MouseMotionEvent{xpos, ypos});
+            state->m_pendingMotion.emplace(Event::Type::MouseMotion, MouseMotionEvent{xpos, ypos});
         }
     );
 
@@ -103,9 +98,9 @@ Window::Window(const Config &config, const char *title) :
         m_window, [](GLFWwindow *window, int button, int action, int mods) {
             Window *state = Window::getState(window);
             switch (action) {
-                case GLFW_PRESS:state->m_events.emplace_back(Event::Type::MouseDown, MouseButtonEvent{button, mods});
+                case GLFW_PRESS:state->pushEvent({Event::Type::MouseDown, MouseButtonEvent{button, mods}});
                     return;
-                case GLFW_RELEASE:state->m_events.emplace_back(Event::Type::MouseUp, MouseButtonEvent{button, mods});
+                case GLFW_RELEASE:state->pushEvent({Event::Type::MouseUp, MouseButtonEvent{button, mods}});
                 default:return;
             }
         }
@@ -114,7 +109,14 @@ Window::Window(const Config &config, const char *title) :
     glfwSetCharCallback(
         m_window, [](GLFWwindow *window, unsigned int codepoint) {
             Window *state = Window::getState(window);
-            state->m_events.emplace_back(Event::Type::TextInput, TextEvent{codepoint});
+            state->pushEvent({Event::Type::TextInput, TextEvent{codepoint}});
+        }
+    );
+
+    glfwSetWindowRefreshCallback(
+        m_window, [](GLFWwindow *window) {
+            Window *state = Window::getState(window);
+            state->m_damaged.store(true, std::memory_order_relaxed);
         }
     );
 
@@ -135,6 +137,28 @@ void Window::swapBuffers() {
 
 void Window::update() {
     glfwPollEvents();
+    flushMotion();
+}
+
+
+void Window::wait(double timeout) {
+    glfwWaitEventsTimeout(timeout);
+    flushMotion();
+}
+
+
+void Window::wake() {
+    glfwPostEmptyEvent();
+}
+
+
+void Window::swapInterval(int interval) {
+    glfwSwapInterval(interval);
+}
+
+
+bool Window::damaged() {
+    return m_damaged.exchange(false, std::memory_order_relaxed);
 }
 
 
@@ -143,18 +167,43 @@ void Window::clear() {
 }
 
 
+void Window::queueEvent(const Event &event) {
+    if (!m_events.push(event)) {
+        m_droppedEvents.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void Window::flushMotion() {
+    if (m_pendingMotion.has_value()) {
+        queueEvent(m_pendingMotion.value());
+        m_pendingMotion.reset();
+    }
+}
+
 std::optional<Event> Window::pollEvent() {
-    if (m_events.empty()) {
-        return std::nullopt;
-    } else {
-        Event event = m_events.back();
-        m_events.pop_back();
-        return event;
+    std::optional<Event> event = m_events.pop();
+
+    // Motion that was queued across separate polls can still be back to back. Only the latest position matters.
+    while (event.has_value() && event->type == Event::Type::MouseMotion) {
+        const Event *next = m_events.peek();
+        if (next == nullptr || next->type != Event::Type::MouseMotion) {
+            break;
+        }
+
+        event = m_events.pop();
     }
+
+    return event;
 }
 
 void Window::pushEvent(Event event) {
-    m_events.push_back(event);
+    // Keep the pending motion ahead of this event so the order is preserved.
+    flushMotion();
+    queueEvent(event);
+}
+
+size_t Window::droppedEvents() const {
+    return m_droppedEvents.load(std::memory_order_relaxed);
 }
 
 void Window::shouldClose(bool value) {
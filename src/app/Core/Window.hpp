@@ -2,9 +2,11 @@
 
 #include "pch.hpp"
 #include "Event.hpp"
+#include "RingQueue.hpp"
 
 
-extern constexpr size_t eventStackCapacity = 3;
+// Events beyond this many unread ones are dropped. Must be a power of two.
+constexpr size_t eventQueueCapacity = 256;
 
 
 template<typename T>
@@ -27,6 +29,7 @@ struct Config {
 
     uint8_t samples = 8;
     bool resizable = false;  // This can be converted to a flag bit type thing when additional features are required.
+    bool visible = true;     // Hidden windows still get a context, e.g. for rendering offscreen.
     friend Window;
 
     Config(uint32_t width, uint32_t height);
@@ -37,7 +40,19 @@ class Window {
     const char *m_title;
     GLFWwindow *m_window;
     const Config m_config;
-    std::vector<Event> m_events;
+    RingQueue<Event, eventQueueCapacity> m_events;
+
+    // Producer side. Cursor motion is held here until another event arrives or the poll ends,
+    //   so a burst of motion becomes a single event.
+    std::optional<Event> m_pendingMotion;
+    std::atomic<size_t> m_droppedEvents{0};
+
+    // Set when the window system asks for the contents to be redrawn.
+    std::atomic<bool> m_damaged{true};
+
+    void queueEvent(const Event &event);
+
+    void flushMotion();
 
     static Window *getState(GLFWwindow *window);
 
@@ -62,11 +77,29 @@ public:
 
     void swapBuffers();
 
-    static void update();
+    // Poll GLFW and queue the resulting events. This is the producer side of the event queue.
+    void update();
+
+    // Like update, but sleeps until an event arrives or timeout seconds pass.
+    void wait(double timeout);
+
+    // Wake a thread sleeping in wait. Safe to call from any thread.
+    static void wake();
+
+    // 0 presents immediately, 1 waits for vertical sync.
+    static void swapInterval(int interval);
+
+    // True if the contents need redrawing since the last call.
+    bool damaged();
 
     static void clear();
 
+    // Producer side only.
     void pushEvent(Event event);
 
+    // Consumer side only. Events are returned in the order they arrived.
     std::optional<Event> pollEvent();
+
+    // Events lost because the queue was full.
+    [[nodiscard]] size_t droppedEvents() const;
 };
@@ -0,0 +1,43 @@
+#include "pch.hpp"
+#include "DirectionTable.hpp"
+
+static constexpr double TAU = 6.283185307179586476925286766559;
+
+
+static float *allocate(uint32_t count) {
+    // Padded to whole registers. The padding holds zero vectors, which never hit anything.
+    const size_t padded = (count + directionAlignment - 1) / directionAlignment * directionAlignment;
+    auto *data = new(std::align_val_t(directionAlignment)) float[padded];
+    std::fill(data, data + padded, 0.0f);
+    return data;
+}
+
+void DirectionTable::AlignedDelete::operator()(float *data) const {
+    ::operator delete[](data, std::align_val_t(directionAlignment));
+}
+
+DirectionTable::DirectionTable(uint32_t count) :
+    m_count(count), m_x(allocate(count)), m_y(allocate(count)) {
+    if (count == 0) {
+        throw std::exception("A direction table needs at least one ray.");
+    }
+
+    // Computed in double so the last rays carry no accumulated error.
+    for (uint32_t i = 0; i < count; i++) {
+        const double angle = TAU * double(i) / double(count);
+        m_x[i] = static_cast<float>(std::cos(angle));
+        m_y[i] = static_cast<float>(std::sin(angle));
+    }
+}
+
+uint32_t DirectionTable::count() const {
+    return m_count;
+}
+
+const float *DirectionTable::x() const {
+    return m_x.get();
+}
+
+const float *DirectionTable::y() const {
+    return m_y.get();
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "pch.hpp"
+
+// Bytes each table is aligned to, enough for a full AVX register.
+constexpr size_t directionAlignment = 32;
+
+
+/* ****** Direction Table ******
+* Unit vectors for count rays evenly spaced around the circle, starting at angle 0. The x and y parts are kept
+*   in separate arrays aligned to directionAlignment, so a loop over rays loads whole vector registers instead
+*   of calling cos and sin for every ray of every cast.
+*/
+class DirectionTable {
+    struct AlignedDelete {
+        void operator()(float *data) const;
+    };
+
+    uint32_t m_count;
+    std::unique_ptr<float[], AlignedDelete> m_x;
+    std::unique_ptr<float[], AlignedDelete> m_y;
+
+public:
+    explicit DirectionTable(uint32_t count);
+
+    [[nodiscard]] uint32_t count() const;
+
+    [[nodiscard]] const float *x() const;
+
+    [[nodiscard]] const float *y() const;
+};
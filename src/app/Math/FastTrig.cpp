@@ -0,0 +1,147 @@
+#include "pch.hpp"
+#include "FastTrig.hpp"
+
+static constexpr float M_PI = 3.14159265358979323846f;
+
+// The bounds FastTrig.hpp documents, in ULP and absolute.
+static constexpr double SIN_COS_ULP = 1.5;
+static constexpr double SIN_COS_ABSOLUTE = 1e-7;
+static constexpr double ATAN2_ULP = 3.1;
+static constexpr double ATAN2_ABSOLUTE = 3e-7;
+
+
+void sinCos(TrigPrecision precision, const float *angles, float *sines, float *cosines, size_t count) {
+    if (precision == TrigPrecision::Fast) {
+        for (size_t i = 0; i < count; i++) {
+            fastSinCos(angles[i], sines[i], cosines[i]);
+        }
+    } else {
+        for (size_t i = 0; i < count; i++) {
+            sines[i] = std::sinf(angles[i]);
+            cosines[i] = std::cosf(angles[i]);
+        }
+    }
+}
+
+void arcTangent(TrigPrecision precision, const float *y, const float *x, float *angles, size_t count) {
+    if (precision == TrigPrecision::Fast) {
+        for (size_t i = 0; i < count; i++) {
+            angles[i] = fastAtan2(y[i], x[i]);
+        }
+    } else {
+        for (size_t i = 0; i < count; i++) {
+            angles[i] = std::atan2f(y[i], x[i]);
+        }
+    }
+}
+
+
+static float fromBits(uint32_t bits) {
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// The error of value in units of the last place of the float nearest to exact.
+static double ulpError(float value, double exact) {
+    const float nearest = std::fabs(static_cast<float>(exact));
+    const double ulp = std::nextafter(nearest, std::numeric_limits<float>::infinity()) - nearest;
+    return std::fabs(double(value) - exact) / ulp;
+}
+
+struct TrigError {
+    double ulp = 0.0;
+    double absolute = 0.0;
+
+    void add(float value, double exact) {
+        ulp = std::max(ulp, ulpError(value, exact));
+        absolute = std::max(absolute, std::fabs(double(value) - exact));
+    }
+
+    [[nodiscard]] bool within(double maxUlp, double maxAbsolute) const {
+        return ulp <= maxUlp && absolute <= maxAbsolute;
+    }
+};
+
+template<typename Function>
+static double nanosecondsPerCall(size_t count, Function &&function) {
+    double best = std::numeric_limits<double>::infinity();
+    for (int repeat = 0; repeat < 10; repeat++) {
+        const auto start = std::chrono::steady_clock::now();
+        function();
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count() / double(count));
+    }
+
+    return best;
+}
+
+bool checkTrigAccuracy(std::ostream &stream, uint32_t stride) {
+    TrigError sine;
+    TrigError cosine;
+    uint32_t limit;
+    const float range = 4.0f * M_PI;
+    std::memcpy(&limit, &range, sizeof(limit));
+    for (uint32_t bits = 0; bits <= limit; bits += stride) {
+        for (const float angle : {fromBits(bits), -fromBits(bits)}) {
+            float s, c;
+            fastSinCos(angle, s, c);
+            sine.add(s, std::sin(double(angle)));
+            cosine.add(c, std::cos(double(angle)));
+        }
+    }
+
+    // Every ratio in every quadrant, then points off the axes.
+    TrigError arc;
+    for (uint32_t bits = 0; bits < 0x7F800000u; bits += stride) {
+        const float ratio = fromBits(bits);
+        for (const float y : {ratio, -ratio}) {
+            for (const float x : {1.0f, -1.0f}) {
+                arc.add(fastAtan2(y, x), std::atan2(double(y), double(x)));
+            }
+        }
+    }
+
+    std::vector<float> y(1 << 16);
+    std::vector<float> x(y.size());
+    std::vector<float> out(y.size());
+    std::vector<float> outCosine(y.size());
+    for (size_t i = 0; i < y.size(); i++) {
+        // A fixed low discrepancy pattern rather than random numbers, so every run reports the same.
+        y[i] = std::fmod(float(i) * 0.7548776662f, 1.0f) * 2000.0f - 1000.0f;
+        x[i] = std::fmod(float(i) * 0.5698402910f, 1.0f) * 2000.0f - 1000.0f;
+        arc.add(fastAtan2(y[i], x[i]), std::atan2(double(y[i]), double(x[i])));
+    }
+
+    const auto time = [&](TrigPrecision precision) {
+        const double sines = nanosecondsPerCall(y.size(), [&]() {
+            sinCos(precision, y.data(), out.data(), outCosine.data(), y.size());
+        });
+        const double arcs = nanosecondsPerCall(y.size(), [&]() {
+            arcTangent(precision, y.data(), x.data(), out.data(), y.size());
+        });
+        return std::pair(sines, arcs);
+    };
+
+    const auto [libmSinCos, libmAtan2] = time(TrigPrecision::Libm);
+    const auto [fastSinCosTime, fastAtan2Time] = time(TrigPrecision::Fast);
+
+    const bool sinePassed = sine.within(SIN_COS_ULP, SIN_COS_ABSOLUTE);
+    const bool cosinePassed = cosine.within(SIN_COS_ULP, SIN_COS_ABSOLUTE);
+    const bool arcPassed = arc.within(ATAN2_ULP, ATAN2_ABSOLUTE);
+    const auto verdict = [](bool passed) {
+        return passed ? "ok" : "FAILED";
+    };
+
+    const std::streamsize precision = stream.precision();
+    stream << std::setprecision(3)
+           << "Fast trig, testing one float in " << stride << ":\n"
+           << "  sin   " << sine.ulp << " ULP, " << sine.absolute << " absolute, " << verdict(sinePassed) << '\n'
+           << "  cos   " << cosine.ulp << " ULP, " << cosine.absolute << " absolute, " << verdict(cosinePassed) << '\n'
+           << "  atan2 " << arc.ulp << " ULP, " << arc.absolute << " absolute, " << verdict(arcPassed) << '\n'
+           << "  sincos " << fastSinCosTime << " ns vs " << libmSinCos << " ns in libm, atan2 "
+           << fastAtan2Time << " ns vs " << libmAtan2 << " ns" << std::endl;
+    stream.precision(precision);
+
+    return sinePassed && cosinePassed && arcPassed;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "pch.hpp"
+
+
+/* ****** Fast Trig ******
+* Polynomial sine, cosine and arc tangent for the angles casters work with, selectable per caster.
+*
+* sin and cos reduce the angle by the nearest multiple of pi / 2, subtracted in three parts so the reduction
+*   is exact, and evaluate the Cephes minimax polynomials on [-pi / 4, pi / 4]. atan2 reduces to a ratio in
+*   [0, 1], folds ratios above tan(pi / 8) around pi / 4 and evaluates the Cephes atanf polynomial.
+*
+* Measured against double precision over every float angle with |x| <= 4 pi, sin and cos are within 1.5 ULP
+*   and 1e-7 absolute. atan2 is within 3.1 ULP and 3e-7 absolute over every float ratio and 2e7 random
+*   points. Outside that angle range the reduction loses precision. checkTrigAccuracy repeats the sweep and fails
+*   when either is outside these bounds.
+*
+* Both are written as selects rather than branches, so the batched versions compile to 4 or 8 lane vector loops.
+*   GCC only turns the selects into vector blends with -fno-trapping-math, which FastTrig.cpp is built with.
+*/
+enum class TrigPrecision : uint8_t {
+    Libm,
+    Fast
+};
+
+inline void fastSinCos(float angle, float &sine, float &cosine) {
+    // Rounded by truncating conversion, since nearbyint is a library call without SSE4.1 and stops vectorization.
+    const float scaled = angle * 0.636619772367581343f;
+    const auto q = static_cast<int32_t>(scaled + (scaled < 0.0f ? -0.5f : 0.5f));
+    const auto quadrant = static_cast<float>(q);
+    float r = angle - quadrant * 1.5703125f;
+    r -= quadrant * 4.837512969970703125e-4f;
+    r -= quadrant * 7.54978995489188216e-8f;
+
+    const float z = r * r;
+    const float s = r + r * z * (-1.6666654611e-1f + z * (8.3321608736e-3f + z * -1.9515295891e-4f));
+    const float c = 1.0f - 0.5f * z
+        + z * z * (4.166664568298827e-2f + z * (-1.388731625493765e-3f + z * 2.443315711809948e-5f));
+
+    // Odd quadrants swap sine and cosine, and the quadrant's signs come from its low bits.
+    const float baseSine = (q & 1) != 0 ? c : s;
+    const float baseCosine = (q & 1) != 0 ? s : c;
+    sine = (q & 2) != 0 ? -baseSine : baseSine;
+    cosine = ((q + 1) & 2) != 0 ? -baseCosine : baseCosine;
+}
+
+inline float fastAtan2(float y, float x) {
+    constexpr float pi = 3.14159265358979323846f;
+    const float ax = std::fabs(x);
+    const float ay = std::fabs(y);
+
+    // fmin and fmax would stop the batched loop from vectorizing.
+    const float high = ax > ay ? ax : ay;
+    const float low = ax > ay ? ay : ax;
+    const float t = low / (high == 0.0f ? 1.0f : high);
+
+    const bool fold = t > 0.414213562373095f;
+    const float folded = (t - 1.0f) / (t + 1.0f);
+    const float u = fold ? folded : t;
+    const float z = u * u;
+
+    float angle = (((8.05374449538e-2f * z - 1.38776856032e-1f) * z + 1.99777106478e-1f) * z - 3.33329491539e-1f) * z * u + u;
+    angle += fold ? 0.25f * pi : 0.0f;
+    angle = ay > ax ? 0.5f * pi - angle : angle;
+    angle = x < 0.0f ? pi - angle : angle;
+    return std::copysign(angle, y);
+}
+
+inline void sinCos(TrigPrecision precision, float angle, float &sine, float &cosine) {
+    if (precision == TrigPrecision::Fast) {
+        fastSinCos(angle, sine, cosine);
+    } else {
+        sine = std::sinf(angle);
+        cosine = std::cosf(angle);
+    }
+}
+
+inline float arcTangent(TrigPrecision precision, float y, float x) {
+    return precision == TrigPrecision::Fast ? fastAtan2(y, x) : std::atan2f(y, x);
+}
+
+void sinCos(TrigPrecision precision, const float *angles, float *sines, float *cosines, size_t count);
+
+void arcTangent(TrigPrecision precision, const float *y, const float *x, float *angles, size_t count);
+
+// Sweeps the fast functions against double precision, times them against libm and returns whether they are within
+//   the bounds above. One float in stride is tested, so 1 checks all of them, which takes a few minutes.
+bool checkTrigAccuracy(std::ostream &stream, uint32_t stride = 4093);
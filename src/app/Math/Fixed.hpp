@@ -0,0 +1,72 @@
+#pragma once
+
+#include "pch.hpp"
+
+
+/* ****** Fixed ******
+* A signed 16.16 fixed point number in 32 bits, for integer tile maps where every coordinate is exact.
+*
+* Sums and differences are exact as long as they do not overflow. Products and quotients widen to 64 bits
+*   and truncate back, so kernels that need exact cross products work on the raw values instead.
+*/
+struct Fixed {
+    static constexpr int32_t fractionBits = 16;
+    static constexpr int32_t one = 1 << fractionBits;
+
+    int32_t raw = 0;
+
+    Fixed() = default;
+
+    static constexpr Fixed fromRaw(int32_t raw) {
+        Fixed value;
+        value.raw = raw;
+        return value;
+    }
+
+    static constexpr Fixed fromInt(int32_t value) {
+        return fromRaw(value * one);
+    }
+
+    // Rounds to the nearest representable value.
+    static constexpr Fixed fromFloat(float value) {
+        return fromRaw(static_cast<int32_t>(value * static_cast<float>(one) + (value < 0.0f ? -0.5f : 0.5f)));
+    }
+
+    constexpr explicit operator float() const {
+        return static_cast<float>(raw) / static_cast<float>(one);
+    }
+
+    constexpr explicit operator double() const {
+        return static_cast<double>(raw) / static_cast<double>(one);
+    }
+
+    constexpr Fixed operator-() const { return fromRaw(-raw); }
+
+    constexpr Fixed operator+(Fixed other) const { return fromRaw(raw + other.raw); }
+
+    constexpr Fixed operator-(Fixed other) const { return fromRaw(raw - other.raw); }
+
+    constexpr Fixed operator*(Fixed other) const {
+        return fromRaw(static_cast<int32_t>((static_cast<int64_t>(raw) * other.raw) >> fractionBits));
+    }
+
+    constexpr Fixed operator/(Fixed other) const {
+        return fromRaw(static_cast<int32_t>((static_cast<int64_t>(raw) << fractionBits) / other.raw));
+    }
+
+    constexpr Fixed &operator+=(Fixed other) { return *this = *this + other; }
+
+    constexpr Fixed &operator-=(Fixed other) { return *this = *this - other; }
+
+    constexpr bool operator==(Fixed other) const { return raw == other.raw; }
+
+    constexpr bool operator!=(Fixed other) const { return raw != other.raw; }
+
+    constexpr bool operator<(Fixed other) const { return raw < other.raw; }
+
+    constexpr bool operator<=(Fixed other) const { return raw <= other.raw; }
+
+    constexpr bool operator>(Fixed other) const { return raw > other.raw; }
+
+    constexpr bool operator>=(Fixed other) const { return raw >= other.raw; }
+};
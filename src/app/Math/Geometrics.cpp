@@ -2,63 +2,146 @@
 #include "Geometrics.hpp"
 
 // Point
-Point::Point(float x, float y) : x(x), y(y) {}
+template<typename T>
+BasicPoint<T>::BasicPoint(T x, T y) : x(x), y(y) {}
 
-Point::Point() : x(0.0f), y(0.0f) {}
-
-float Point::distanceTo(const Point &other) const {
-    const float dx = other.x - x;
-    const float dy = other.y - y;
+template<typename T>
+typename BasicPoint<T>::Real BasicPoint<T>::distanceTo(const BasicPoint &other) const {
+    const Real dx = ScalarTraits<T>::toReal(other.x - x);
+    const Real dy = ScalarTraits<T>::toReal(other.y - y);
 
     return dx * dx + dy * dy;
 }
 
 
 // Vector
-Vector::Vector() : x(0.0f), y(0.0f) {}
-
-Vector::Vector(float x, float y) : x(x), y(y) {}
+template<typename T>
+BasicVector<T>::BasicVector(T x, T y) : x(x), y(y) {}
 
-Vector::Vector(const Vector &other) : x(other.x), y(other.y) {}
-
-float Vector::angle() const {
-    return std::atan2f(y, x);
+template<typename T>
+typename BasicVector<T>::Real BasicVector<T>::angle() const {
+    return std::atan2(ScalarTraits<T>::toReal(y), ScalarTraits<T>::toReal(x));
 }
 
 
 // Line
-LineSegment::LineSegment(float x1, float y1, float x2, float y2) : a(x1, y1), b(x2, y2) {}
+template<typename T>
+BasicLineSegment<T>::BasicLineSegment(T x1, T y1, T x2, T y2) : a(x1, y1), b(x2, y2) {}
 
-LineSegment::LineSegment(Point a, Point b) : a(a), b(b) {}
+template<typename T>
+BasicLineSegment<T>::BasicLineSegment(BasicPoint<T> a, BasicPoint<T> b) : a(a), b(b) {}
 
 
 // Ray
-Ray::Ray(float x, float y, float angle) : pos(x, y), dir(std::cosf(angle), std::sinf(angle)) {}
+template<typename T>
+BasicRay<T>::BasicRay(T x, T y, Real angle) :
+    pos(x, y), dir(ScalarTraits<T>::fromReal(std::cos(angle)), ScalarTraits<T>::fromReal(std::sin(angle))) {}
+
+template<typename T>
+std::optional<BasicPoint<T>> BasicRay<T>::intersects(const BasicLineSegment<T> &segment) const {
+    const T x1 = segment.a.x;
+    const T y1 = segment.a.y;
+    const T x2 = segment.b.x;
+    const T y2 = segment.b.y;
+
+    const T x3 = pos.x;
+    const T y3 = pos.y;
+    const T x4 = x3 + dir.x;
+    const T y4 = y3 + dir.y;
+
+    const T den = (x1 - x2) * (y3 - y4) - (y1 - y2) * (x3 - x4);
+    if (den == T(0)) {
+        return std::nullopt;
+    }
 
-Ray::Ray() : pos(0.0f, 0.0f), dir(1.0f, 0.0f) {}
+    const T t = ((x1 - x3) * (y3 - y4) - (y1 - y3) * (x3 - x4)) / den;
+    const T u = -((x1 - x2) * (y1 - y3) - (y1 - y2) * (x1 - x3)) / den;
 
-std::optional<Point> Ray::intersects(const LineSegment &segment) const {
-    const float x1 = segment.a.x;
-    const float y1 = segment.a.y;
-    const float x2 = segment.b.x;
-    const float y2 = segment.b.y;
+    if ((t >= T(0) && t <= T(1)) && u >= T(0)) {
+        return std::make_optional<BasicPoint<T>>(x1 + t * (x2 - x1), y1 + t * (y2 - y1));
+    } else {
+        return std::nullopt;
+    }
+}
+
+template<>
+std::optional<BasicPoint<Fixed>> BasicRay<Fixed>::intersects(const BasicLineSegment<Fixed> &segment) const {
+    const int64_t x1 = segment.a.x.raw;
+    const int64_t y1 = segment.a.y.raw;
+    const int64_t x2 = segment.b.x.raw;
+    const int64_t y2 = segment.b.y.raw;
 
-    const float x3 = pos.x;
-    const float y3 = pos.y;
-    const float x4 = x3 + dir.x;
-    const float y4 = y3 + dir.y;
+    const int64_t x3 = pos.x.raw;
+    const int64_t y3 = pos.y.raw;
+    const int64_t x4 = x3 + dir.x.raw;
+    const int64_t y4 = y3 + dir.y.raw;
 
-    const float den = (x1 - x2) * (y3 - y4) - (y1 - y2) * (x3 - x4);
-    if (den == 0.0f) {
+    int64_t den = (x1 - x2) * (y3 - y4) - (y1 - y2) * (x3 - x4);
+    if (den == 0) {
         return std::nullopt;
     }
 
-    const float t = ((x1 - x3) * (y3 - y4) - (y1 - y3) * (x3 - x4)) / den;
-    const float u = -((x1 - x2) * (y1 - y3) - (y1 - y2) * (x1 - x3)) / den;
+    // The same t and u as the floating point kernel, compared as fractions so the decision is exact.
+    int64_t t = (x1 - x3) * (y3 - y4) - (y1 - y3) * (x3 - x4);
+    int64_t u = -((x1 - x2) * (y1 - y3) - (y1 - y2) * (x1 - x3));
+    if (den < 0) {
+        den = -den;
+        t = -t;
+        u = -u;
+    }
 
-    if ((t >= 0.0f && t <= 1.0f) && u >= 0.0f) {
-        return std::make_optional<Point>(x1 + t * (x2 - x1), y1 + t * (y2 - y1));
-    } else {
+    if (t < 0 || t > den || u < 0) {
         return std::nullopt;
     }
+
+    const double along = static_cast<double>(t) / static_cast<double>(den);
+    return std::make_optional<BasicPoint<Fixed>>(
+        Fixed::fromRaw(static_cast<int32_t>(x1 + std::llround(along * static_cast<double>(x2 - x1)))),
+        Fixed::fromRaw(static_cast<int32_t>(y1 + std::llround(along * static_cast<double>(y2 - y1))))
+    );
 }
+
+
+// Hit Scalar
+template<typename T>
+static BasicPoint<T> toHitScalar(const Point &point) {
+    return {ScalarTraits<T>::fromReal(point.x), ScalarTraits<T>::fromReal(point.y)};
+}
+
+std::optional<Point> intersection(const Ray &ray, const LineSegment &segment) {
+    if constexpr (floatHits) {
+        return ray.intersects(segment);
+    } else {
+        BasicRay<HitScalar> converted;
+        converted.pos = toHitScalar<HitScalar>(ray.pos);
+        converted.dir.x = ScalarTraits<HitScalar>::fromReal(ray.dir.x);
+        converted.dir.y = ScalarTraits<HitScalar>::fromReal(ray.dir.y);
+
+        const auto hit = converted.intersects({toHitScalar<HitScalar>(segment.a), toHitScalar<HitScalar>(segment.b)});
+        if (!hit) {
+            return std::nullopt;
+        }
+
+        return std::make_optional<Point>(
+            static_cast<float>(ScalarTraits<HitScalar>::toReal(hit->x)),
+            static_cast<float>(ScalarTraits<HitScalar>::toReal(hit->y))
+        );
+    }
+}
+
+
+template struct BasicPoint<float>;
+template struct BasicPoint<double>;
+template struct BasicPoint<Fixed>;
+
+template struct BasicVector<float>;
+template struct BasicVector<double>;
+template struct BasicVector<Fixed>;
+
+template struct BasicLineSegment<float>;
+template struct BasicLineSegment<double>;
+template struct BasicLineSegment<Fixed>;
+
+template struct BasicRay<float>;
+template struct BasicRay<double>;
+template struct BasicRay<Fixed>;
@@ -1,46 +1,136 @@
 #pragma once
 
 #include "pch.hpp"
+#include "Fixed.hpp"
 
-struct Point {
-    float x, y;
 
-    Point(float x, float y);
+/* ****** Scalar Traits ******
+* What the geometry needs to know about its coordinate type.
+*   Real - the floating point type used for angles and distances.
+*
+* float and double are their own Real. Fixed uses float, as its coordinates always fit one exactly.
+*/
+template<typename T>
+struct ScalarTraits;
 
-    Point();
+template<>
+struct ScalarTraits<float> {
+    using Real = float;
 
-    [[nodiscard]] float distanceTo(const Point &other) const;
+    static constexpr float fromReal(Real value) { return value; }
+
+    static constexpr Real toReal(float value) { return value; }
+};
+
+template<>
+struct ScalarTraits<double> {
+    using Real = double;
+
+    static constexpr double fromReal(Real value) { return value; }
+
+    static constexpr Real toReal(double value) { return value; }
+};
+
+template<>
+struct ScalarTraits<Fixed> {
+    using Real = float;
+
+    static constexpr Fixed fromReal(Real value) { return Fixed::fromFloat(value); }
+
+    static constexpr Real toReal(Fixed value) { return static_cast<Real>(value); }
 };
 
-struct Vector {
-    float x, y;
 
-    Vector();
+/* ****** Geometry ******
+* Trivially copyable over any scalar with ScalarTraits, so arrays of them can be copied and uploaded as raw memory.
+*   Members are defined and explicitly instantiated for float, double and Fixed in Geometrics.cpp.
+*/
+template<typename T>
+struct BasicPoint {
+    using Real = typename ScalarTraits<T>::Real;
 
-    Vector(float x, float y);
+    T x{}, y{};
 
-    Vector(const Vector &other);
+    BasicPoint() = default;
 
-    [[nodiscard]] float angle() const;
+    BasicPoint(T x, T y);
+
+    // Squared, since distances are only ever compared.
+    [[nodiscard]] Real distanceTo(const BasicPoint &other) const;
 };
 
-struct LineSegment {
-    Point a, b;
+template<typename T>
+struct BasicVector {
+    using Real = typename ScalarTraits<T>::Real;
+
+    T x{}, y{};
 
-    LineSegment() = default;
+    BasicVector() = default;
 
-    LineSegment(float x1, float y1, float x2, float y2);
+    BasicVector(T x, T y);
 
-    LineSegment(Point a, Point b);
+    [[nodiscard]] Real angle() const;
 };
 
-struct Ray {
-    Point pos;
-    Vector dir;
+template<typename T>
+struct BasicLineSegment {
+    BasicPoint<T> a, b;
 
-    Ray(float x, float y, float angle);
+    BasicLineSegment() = default;
 
-    Ray();
+    BasicLineSegment(T x1, T y1, T x2, T y2);
 
-    [[nodiscard]] std::optional<Point> intersects(const LineSegment &bound) const;
+    BasicLineSegment(BasicPoint<T> a, BasicPoint<T> b);
 };
+
+template<typename T>
+struct BasicRay {
+    using Real = typename ScalarTraits<T>::Real;
+
+    BasicPoint<T> pos;
+    BasicVector<T> dir{ScalarTraits<T>::fromReal(1), T{}};
+
+    BasicRay(T x, T y, Real angle);
+
+    BasicRay() = default;
+
+    [[nodiscard]] std::optional<BasicPoint<T>> intersects(const BasicLineSegment<T> &bound) const;
+};
+
+// Cross products of raw coordinates are exact in 64 bits while coordinates stay within +-16384,
+//   so only the returned point is rounded.
+template<>
+std::optional<BasicPoint<Fixed>> BasicRay<Fixed>::intersects(const BasicLineSegment<Fixed> &bound) const;
+
+
+// Casting and rendering work in float.
+using Point = BasicPoint<float>;
+using Vector = BasicVector<float>;
+using LineSegment = BasicLineSegment<float>;
+using Ray = BasicRay<float>;
+
+
+/* ****** Hit Scalar ******
+* The scalar the hit tests run in, picked per build with the RAY_CASTING_SCALAR CMake option.
+*   Scenes, casting and rendering stay in float, since the vertex buffers are float, so intersection converts
+*   the ray and segment to HitScalar, tests them there, and converts the hit back.
+*   Fixed decides integer tile maps exactly. double is there for scenes far from the origin.
+*/
+#if defined(RAY_CASTING_SCALAR_DOUBLE)
+using HitScalar = double;
+#elif defined(RAY_CASTING_SCALAR_FIXED)
+using HitScalar = Fixed;
+#else
+using HitScalar = float;
+#endif
+
+// The batched float kernels of the casters only agree with intersection when it runs in float as well.
+//   Casters test one ray at a time through intersection otherwise.
+constexpr bool floatHits = std::is_same_v<HitScalar, float>;
+
+// Ray::intersects, evaluated in HitScalar.
+std::optional<Point> intersection(const Ray &ray, const LineSegment &segment);
+
+static_assert(std::is_trivially_copyable_v<BasicRay<float>> && std::is_trivially_copyable_v<BasicLineSegment<float>>);
+static_assert(std::is_trivially_copyable_v<BasicRay<double>> && std::is_trivially_copyable_v<BasicLineSegment<double>>);
+static_assert(std::is_trivially_copyable_v<BasicRay<Fixed>> && std::is_trivially_copyable_v<BasicLineSegment<Fixed>>);
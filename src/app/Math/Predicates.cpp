@@ -0,0 +1,205 @@
+#include "pch.hpp"
+#include "Predicates.hpp"
+
+// Bound on the rounding error of (a - b)(c - d) - (e - f)(g - h) evaluated in double, relative to
+//   |(a - b)(c - d)| + |(e - f)(g - h)|. Shewchuk's ccwerrboundA with the unit roundoff of double.
+static constexpr double doubleEpsilon = 1.0 / 9007199254740992.0;  // 2^-53
+static constexpr double doubleBound = (3.0 + 16.0 * doubleEpsilon) * doubleEpsilon;
+
+
+static int sign(double value) {
+    return (value > 0.0) - (value < 0.0);
+}
+
+
+// Error free transformations. The pair (value, error) represents the exact result.
+static void twoSum(double a, double b, double &sum, double &error) {
+    sum = a + b;
+    const double virtualB = sum - a;
+    const double virtualA = sum - virtualB;
+    error = (a - virtualA) + (b - virtualB);
+}
+
+static void twoProduct(double a, double b, double &product, double &error) {
+    product = a * b;
+    error = std::fma(a, b, -product);
+}
+
+
+// A nonoverlapping expansion, components in increasing magnitude. The sign of the sum is the sign
+//   of the largest nonzero component.
+class Expansion {
+    // Two products of two term differences give 8 terms, and each addition can add one component.
+    std::array<double, 32> m_terms{};
+    size_t m_size = 0;
+
+public:
+    void add(double value) {
+        double carry = value;
+        size_t kept = 0;
+        for (size_t i = 0; i < m_size; i++) {
+            double sum, error;
+            twoSum(carry, m_terms[i], sum, error);
+            carry = sum;
+            if (error != 0.0) {
+                m_terms[kept++] = error;
+            }
+        }
+
+        if (carry != 0.0) {
+            m_terms[kept++] = carry;
+        }
+
+        m_size = kept;
+    }
+
+    [[nodiscard]] int sign() const {
+        return m_size == 0 ? 0 : ::sign(m_terms[m_size - 1]);
+    }
+};
+
+
+static int exactCrossSign(float ax, float ay, float bx, float by, float cx, float cy, float dx, float dy) {
+    // Differences of floats are exact as a double pair, and products of doubles are exact as a pair.
+    double abx, abxError, cdy, cdyError, aby, abyError, cdx, cdxError;
+    twoSum(ax, -static_cast<double>(bx), abx, abxError);
+    twoSum(cy, -static_cast<double>(dy), cdy, cdyError);
+    twoSum(ay, -static_cast<double>(by), aby, abyError);
+    twoSum(cx, -static_cast<double>(dx), cdx, cdxError);
+
+    const double left[2] = {abx, abxError};
+    const double leftOther[2] = {cdy, cdyError};
+    const double right[2] = {aby, abyError};
+    const double rightOther[2] = {cdx, cdxError};
+
+    Expansion determinant;
+    for (double l : left) {
+        for (double r : leftOther) {
+            double product, error;
+            twoProduct(l, r, product, error);
+            determinant.add(product);
+            determinant.add(error);
+        }
+    }
+
+    for (double l : right) {
+        for (double r : rightOther) {
+            double product, error;
+            twoProduct(l, r, product, error);
+            determinant.add(-product);
+            determinant.add(-error);
+        }
+    }
+
+    return determinant.sign();
+}
+
+
+int crossSignSlow(float ax, float ay, float bx, float by, float cx, float cy, float dx, float dy) {
+    const double left = (static_cast<double>(ax) - bx) * (static_cast<double>(cy) - dy);
+    const double right = (static_cast<double>(ay) - by) * (static_cast<double>(cx) - dx);
+    const double determinant = left - right;
+    if (std::fabs(determinant) > doubleBound * (std::fabs(left) + std::fabs(right))) {
+        return sign(determinant);
+    }
+
+    return exactCrossSign(ax, ay, bx, by, cx, cy, dx, dy);
+}
+
+int orient2d(const Point &a, const Point &b, const Point &c) {
+    return crossSign(a.x, a.y, c.x, c.y, b.x, b.y, c.x, c.y);
+}
+
+
+// The sign of determinant = left - right when the float filter can decide it, otherwise 2.
+static int filteredSign(float determinant, float left, float right) {
+    if (std::fabs(determinant) > floatCrossBound * (std::fabs(left) + std::fabs(right))) {
+        return (determinant > 0.0f) - (determinant < 0.0f);
+    }
+
+    return 2;
+}
+
+
+std::optional<Point> robustIntersection(const Ray &ray, const LineSegment &segment) {
+    const Point &a = segment.a;
+    const Point &b = segment.b;
+    const Point &p = ray.pos;
+    const Vector &d = ray.dir;
+
+    // Which side of the ray's line each endpoint is on. Touching counts as a hit.
+    //   The float stages are evaluated here directly so most segments are rejected before any slow path is considered.
+    const float ax = a.x - p.x;
+    const float ay = a.y - p.y;
+    const float bx = b.x - p.x;
+    const float by = b.y - p.y;
+
+    int sideA = filteredSign(d.x * ay - d.y * ax, d.x * ay, d.y * ax);
+    int sideB = filteredSign(d.x * by - d.y * bx, d.x * by, d.y * bx);
+    if (sideA * sideB == 1) {
+        return std::nullopt;
+    }
+
+    if (sideA == 2) {
+        sideA = crossSignSlow(d.x, d.y, 0.0f, 0.0f, a.x, a.y, p.x, p.y);
+    }
+
+    if (sideB == 2) {
+        sideB = crossSignSlow(d.x, d.y, 0.0f, 0.0f, b.x, b.y, p.x, p.y);
+    }
+
+    if (sideA * sideB > 0 || (sideA == 0 && sideB == 0)) {
+        // Both on one side, or collinear with the ray, which Ray::intersects also treats as a miss.
+        return std::nullopt;
+    }
+
+    // The segment's line must cross in front of the origin: (a - p) x (b - a) and d x (b - a) agree in sign.
+    //   d x (b - a) is exactly the difference of the two sides, so its sign is already known.
+    const int facing = sideB > sideA ? 1 : -1;
+    const int ahead = crossSign(a.x, a.y, p.x, p.y, b.x, b.y, a.x, a.y);
+    if (ahead * facing < 0) {
+        return std::nullopt;
+    }
+
+    // The hit is certain, so compute where it is in double and keep it on the segment.
+    const double ex = static_cast<double>(b.x) - a.x;
+    const double ey = static_cast<double>(b.y) - a.y;
+    const double denominator = static_cast<double>(d.x) * ey - static_cast<double>(d.y) * ex;
+    const double along = (static_cast<double>(d.x) * (static_cast<double>(p.y) - a.y)
+                          - static_cast<double>(d.y) * (static_cast<double>(p.x) - a.x)) / denominator;
+    const double s = std::clamp(along, 0.0, 1.0);
+
+    return std::make_optional<Point>(
+        static_cast<float>(a.x + s * ex), static_cast<float>(a.y + s * ey)
+    );
+}
+
+void straddlingSegments(const Ray &ray, const std::vector<LineSegment> &segments, std::vector<uint32_t> &indices) {
+    const Point &p = ray.pos;
+    const Vector &d = ray.dir;
+
+    // Every index is written, and the count only advances past the ones kept.
+    indices.resize(segments.size());
+    uint32_t *kept = indices.data();
+    size_t count = 0;
+    for (size_t i = 0; i < segments.size(); i++) {
+        const LineSegment &segment = segments[i];
+        const float leftA = d.x * (segment.a.y - p.y);
+        const float rightA = d.y * (segment.a.x - p.x);
+        const float leftB = d.x * (segment.b.y - p.y);
+        const float rightB = d.y * (segment.b.x - p.x);
+
+        // The same bounds as the float stage of robustIntersection, so it drops nothing that test could hit.
+        const float crossA = leftA - rightA;
+        const float crossB = leftB - rightB;
+        const float boundA = floatCrossBound * (std::fabs(leftA) + std::fabs(rightA));
+        const float boundB = floatCrossBound * (std::fabs(leftB) + std::fabs(rightB));
+        const bool left = (crossA > boundA) & (crossB > boundB);
+        const bool right = (-crossA > boundA) & (-crossB > boundB);
+
+        kept[count] = static_cast<uint32_t>(i);
+        count += !(left | right);
+    }
+
+    indices.resize(count);
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "pch.hpp"
+#include "Geometrics.hpp"
+
+
+/* ****** Robust Predicates ******
+* Exact sign tests for 2D geometry on float coordinates.
+*
+* Each test is evaluated adaptively: first in float against a static bound on its rounding error,
+*   then in double against a tighter bound, and only when both are inconclusive exactly, by summing
+*   the products of error free differences as a floating point expansion.
+*   Nearly every call is decided by the float stage, so the exact stage costs almost nothing on average.
+*/
+
+// Bound on the rounding error of (a - b)(c - d) - (e - f)(g - h) evaluated in float, relative to
+//   |(a - b)(c - d)| + |(e - f)(g - h)|. Shewchuk's ccwerrboundA with the unit roundoff of float, 2^-24.
+constexpr float floatCrossBound = static_cast<float>((3.0 + 16.0 / 16777216.0) / 16777216.0);
+
+// The double and exact stages of crossSign, for when the float stage cannot decide.
+int crossSignSlow(float ax, float ay, float bx, float by, float cx, float cy, float dx, float dy);
+
+// The sign of (a - b) x (c - d), i.e. (ax - bx)(cy - dy) - (ay - by)(cx - dx). Returns -1, 0 or 1.
+//   The float stage is inline so the common case costs about as much as the plain float expression.
+inline int crossSign(float ax, float ay, float bx, float by, float cx, float cy, float dx, float dy) {
+    const float left = (ax - bx) * (cy - dy);
+    const float right = (ay - by) * (cx - dx);
+    const float determinant = left - right;
+    if (std::fabs(determinant) > floatCrossBound * (std::fabs(left) + std::fabs(right))) {
+        return (determinant > 0.0f) - (determinant < 0.0f);
+    }
+
+    return crossSignSlow(ax, ay, bx, by, cx, cy, dx, dy);
+}
+
+// 1 if c is left of the directed line a to b, -1 if right, 0 if exactly on it.
+int orient2d(const Point &a, const Point &b, const Point &c);
+
+// Like Ray::intersects, but the hit test is exact and a ray passing exactly through an endpoint always hits,
+//   so light cannot leak between two segments that share a vertex. The returned point is clamped to the segment.
+std::optional<Point> robustIntersection(const Ray &ray, const LineSegment &segment);
+
+// Replaces indices with those of the segments that may cross the ray's line, dropping every segment the float filter
+//   puts certainly on one side of it. The loop has no branches, so one pass over a whole scene is cheaper than
+//   rejecting the same segments one robustIntersection call at a time. Run robustIntersection on what remains.
+void straddlingSegments(const Ray &ray, const std::vector<LineSegment> &segments, std::vector<uint32_t> &indices);
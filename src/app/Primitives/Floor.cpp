@@ -10,27 +10,20 @@ Floor::Floor() {
         0.0f, 0.0f, 0.0f, 1.0f
     };
 
-    vao.bind();
-
-    vbo.bind();
     vbo.usage(lwvl::Usage::Static);
     vbo.construct(positions, 16);
 
-    vao.attribute(2, GL_FLOAT, 4 * sizeof(float), 0);
-    vao.attribute(2, GL_FLOAT, 4 * sizeof(float), 2 * sizeof(float));
+    vao.attribute(vbo, 2, GL_FLOAT, 4 * sizeof(float), 0);
+    vao.attribute(vbo, 2, GL_FLOAT, 4 * sizeof(float), 2 * sizeof(float));
 
     uint8_t indices[6] = {
         0, 1, 2,
         2, 3, 0
     };
 
-    ebo.bind();
     ebo.usage(lwvl::Usage::Static);
     ebo.construct(indices, 6);
-
-    lwvl::VertexArray::clear();
-    lwvl::ArrayBuffer::clear();
-    lwvl::ElementBuffer::clear();
+    vao.elements(ebo);
 }
 
 Floor::Floor(float left, float bottom, float width, float height) :
@@ -43,27 +36,20 @@ Floor::Floor(float left, float bottom, float width, float height) :
         left, bottom + height, 0.0f, 1.0f
     };
 
-    vao.bind();
-
-    vbo.bind();
     vbo.usage(lwvl::Usage::Static);
     vbo.construct(positions, 16);
 
-    vao.attribute(2, GL_FLOAT, 4 * sizeof(float), 0);
-    vao.attribute(2, GL_FLOAT, 4 * sizeof(float), 2 * sizeof(float));
+    vao.attribute(vbo, 2, GL_FLOAT, 4 * sizeof(float), 0);
+    vao.attribute(vbo, 2, GL_FLOAT, 4 * sizeof(float), 2 * sizeof(float));
 
     uint8_t indices[6] = {
         0, 1, 2,
         2, 3, 0
     };
 
-    ebo.bind();
     ebo.usage(lwvl::Usage::Static);
     ebo.construct(indices, 6);
-
-    lwvl::VertexArray::clear();
-    lwvl::ArrayBuffer::clear();
-    lwvl::ElementBuffer::clear();
+    vao.elements(ebo);
 }
 
 Floor::Floor(Floor &&other) noexcept: vao(other.vao), vbo(other.vbo), ebo(other.ebo) {}
@@ -75,9 +61,12 @@ Floor &Floor::operator=(Floor &&other) noexcept {
     return *this;
 }
 
+DrawCall Floor::drawCall() {
+    return DrawCall::elements(vao, lwvl::PrimitiveMode::Triangles, 6, lwvl::ByteFormat::UnsignedByte);
+}
+
 void Floor::draw() {
-    vao.bind();
-    vao.drawElements(lwvl::PrimitiveMode::Triangles, 6, lwvl::ByteFormat::UnsignedByte);
+    drawCall().execute();
 }
 
 void Floor::update(float left, float bottom, float width, float height) {
@@ -92,8 +81,6 @@ void Floor::update(float left, float bottom, float width, float height) {
         left, bottom + height,
     };
 
-    vbo.bind();
-
     // Update positions and skip updating texture coordinates.
     vbo.update(positions + 0, 2, 0);
     vbo.update(positions + 2, 2, 4);
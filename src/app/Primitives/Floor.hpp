@@ -4,6 +4,7 @@
 #include "Math/Geometrics.hpp"
 #include "VertexArray.hpp"
 #include "Buffer.hpp"
+#include "Render/DrawCall.hpp"
 
 class Floor {
     lwvl::VertexArray vao;
@@ -27,5 +28,7 @@ public:
 
     void update(float left, float bottom, float width, float height);
 
+    DrawCall drawCall();
+
     void draw();
 };
@@ -0,0 +1,56 @@
+#include "pch.hpp"
+#include "NodeRenderer.hpp"
+
+
+std::vector<float> NodeRenderer::collectData() {
+    std::vector<float> temp(m_capacity * 4, 0.0f);
+
+    size_t currentElements = size();
+    for (size_t i = 0; i < currentElements; i++) {
+        LineSegment &segment = m_segments[i];
+        temp[i * 4 + 0] = segment.a.x;
+        temp[i * 4 + 1] = segment.a.y;
+        temp[i * 4 + 2] = segment.b.x;
+        temp[i * 4 + 3] = segment.b.y;
+    }
+
+    return temp;
+}
+
+NodeRenderer::NodeRenderer(size_t capacity) : m_capacity(capacity) {
+    m_segments.reserve(capacity);
+
+    vbo.usage(lwvl::Usage::Dynamic);
+
+    std::vector<float> data = collectData();
+    vbo.construct(data.begin(), data.end());
+    vao.attribute(vbo, 2, GL_FLOAT, 2 * sizeof(float), 0);
+}
+
+void NodeRenderer::add(LineSegment &&segment) {
+    m_segments.push_back(segment);
+}
+
+void NodeRenderer::add(const std::vector<LineSegment> &segments) {
+    m_segments.insert(m_segments.end(), segments.begin(), segments.end());
+}
+
+void NodeRenderer::update() {
+    if (size() > m_capacity) {
+        m_capacity = size();
+        std::vector<float> data = collectData();
+        vbo.construct(data.begin(), data.end());
+        return;
+    }
+
+    std::vector<float> data = collectData();
+    vbo.update(data.begin(), data.end());
+}
+
+DrawCall NodeRenderer::drawCall() {
+    return DrawCall::arrays(vao, lwvl::PrimitiveMode::Lines, static_cast<int32_t>(size() * 2));
+}
+
+void NodeRenderer::draw() {
+    drawCall().execute();
+}
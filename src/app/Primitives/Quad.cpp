@@ -9,24 +9,18 @@ Quad::Quad(float left, float bottom, float width, float height) {
         left, bottom + height
     };
 
-    vao.bind();
-    vbo.bind();
     vbo.usage(lwvl::Usage::Static);
     vbo.construct(positions, 8);
-    vao.attribute(2, GL_FLOAT, 2 * sizeof(float), 0);
+    vao.attribute(vbo, 2, GL_FLOAT, 2 * sizeof(float), 0);
 
     uint8_t indices[6]{
         0, 1, 2,
         2, 3, 0
     };
 
-    ebo.bind();
     ebo.usage(lwvl::Usage::Static);
     ebo.construct(indices, 6);
-
-    lwvl::VertexArray::clear();
-    lwvl::ArrayBuffer::clear();
-    lwvl::ElementBuffer::clear();
+    vao.elements(ebo);
 }
 
 Quad::Quad(Quad &&other) noexcept: vao(other.vao), vbo(other.vbo), ebo(other.ebo) {}
@@ -0,0 +1,99 @@
+#include "pch.hpp"
+#include "CastStats.hpp"
+
+
+/* ****** Cast Stats ****** */
+double CastStats::averageHits() const {
+    return resolved != 0 ? static_cast<double>(hits) / static_cast<double>(resolved) : 0.0;
+}
+
+double CastStats::pruneRate() const {
+    const uint64_t considered = segmentTests + pruned;
+    return considered != 0 ? static_cast<double>(pruned) / static_cast<double>(considered) : 0.0;
+}
+
+CastStats &CastStats::operator+=(const CastStats &other) {
+    rays += other.rays;
+    segmentTests += other.segmentTests;
+    hits += other.hits;
+    resolved += other.resolved;
+    pruned += other.pruned;
+    bytesUploaded += other.bytesUploaded;
+    return *this;
+}
+
+CastStats &castStats() {
+    thread_local CastStats stats;
+    return stats;
+}
+
+CastStats takeCastStats() {
+    CastStats &stats = castStats();
+    const CastStats taken = stats;
+    stats = CastStats();
+    return taken;
+}
+
+
+/* ****** Cast Stats Log ****** */
+void CastStatsLog::print(std::ostream &stream, const CastStats &stats, uint64_t frames) {
+    const auto perFrame = [frames](uint64_t value) {
+        return frames != 0 ? value / frames : 0;
+    };
+
+    stream << perFrame(stats.rays) << " rays, " << perFrame(stats.segmentTests) << " segment tests, "
+           << perFrame(stats.hits) << " hits (" << stats.averageHits() << " per ray that hit), "
+           << perFrame(stats.pruned) << " pruned (" << 100.0 * stats.pruneRate() << "%), "
+           << perFrame(stats.bytesUploaded) << " bytes uploaded";
+}
+
+void CastStatsLog::record(const CastStats &frame) {
+    m_last = frame;
+    m_total += frame;
+    m_interval += frame;
+    m_frames++;
+    m_intervalFrames++;
+
+    if (frame.segmentTests >= m_peak.segmentTests) {
+        m_peak = frame;
+    }
+}
+
+const CastStats &CastStatsLog::last() const {
+    return m_last;
+}
+
+const CastStats &CastStatsLog::total() const {
+    return m_total;
+}
+
+const CastStats &CastStatsLog::peak() const {
+    return m_peak;
+}
+
+uint64_t CastStatsLog::frames() const {
+    return m_frames;
+}
+
+void CastStatsLog::periodic(std::ostream &stream, double seconds) {
+    const auto now = std::chrono::steady_clock::now();
+    if (std::chrono::duration<double>(now - m_intervalStart).count() < seconds) {
+        return;
+    }
+
+    stream << "[Casting] " << m_intervalFrames << " frames, per frame: ";
+    print(stream, m_interval, m_intervalFrames);
+    stream << std::endl;
+
+    m_interval = CastStats();
+    m_intervalFrames = 0;
+    m_intervalStart = now;
+}
+
+void CastStatsLog::summary(std::ostream &stream) const {
+    stream << "Casting per frame: ";
+    print(stream, m_total, m_frames);
+    stream << "\nCasting peak frame: ";
+    print(stream, m_peak, 1);
+    stream << std::endl;
+}
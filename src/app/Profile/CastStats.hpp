@@ -0,0 +1,71 @@
+#pragma once
+
+#include "pch.hpp"
+
+
+struct CastStats {
+    uint64_t rays = 0;
+    uint64_t segmentTests = 0;
+    uint64_t hits = 0;
+
+    // Rays that hit anything, i.e. the calls to closestIntersection.
+    uint64_t resolved = 0;
+
+    // Segments skipped without a test because they were further than the hit a ray was seeded with.
+    uint64_t pruned = 0;
+
+    uint64_t bytesUploaded = 0;
+
+    // The average hit list length handed to closestIntersection.
+    [[nodiscard]] double averageHits() const;
+
+    // The share of the segments considered that were pruned, from 0 to 1.
+    [[nodiscard]] double pruneRate() const;
+
+    CastStats &operator+=(const CastStats &other);
+};
+
+
+// The calling thread's counters. Casting code adds to these as it goes.
+CastStats &castStats();
+
+// Return the calling thread's counters and reset them.
+CastStats takeCastStats();
+
+
+/* ****** Cast Stats Log ******
+* Collects the casting work of each presented frame.
+*
+* Usage:
+*   log.record(takeCastStats());    // Once per presented frame.
+*   log.last().segmentTests;        // The most recent frame.
+*   log.periodic(std::cout, 2.0);   // Prints the average over the interval when it has passed.
+*/
+class CastStatsLog {
+    CastStats m_last;
+    CastStats m_total;
+    uint64_t m_frames = 0;
+    CastStats m_peak;
+
+    CastStats m_interval;
+    uint64_t m_intervalFrames = 0;
+    std::chrono::steady_clock::time_point m_intervalStart = std::chrono::steady_clock::now();
+
+    static void print(std::ostream &stream, const CastStats &stats, uint64_t frames);
+
+public:
+    void record(const CastStats &frame);
+
+    [[nodiscard]] const CastStats &last() const;
+
+    [[nodiscard]] const CastStats &total() const;
+
+    // The frame with the most segment tests.
+    [[nodiscard]] const CastStats &peak() const;
+
+    [[nodiscard]] uint64_t frames() const;
+
+    void periodic(std::ostream &stream, double seconds);
+
+    void summary(std::ostream &stream) const;
+};
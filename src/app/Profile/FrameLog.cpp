@@ -0,0 +1,71 @@
+#include "pch.hpp"
+#include "FrameLog.hpp"
+
+
+void FrameLog::record(const FrameSample &sample) {
+    m_samples.push_back(sample);
+}
+
+const std::vector<FrameSample> &FrameLog::samples() const {
+    return m_samples;
+}
+
+double FrameLog::percentile(double FrameSample::*field, double fraction) const {
+    if (m_samples.empty()) {
+        return 0.0;
+    }
+
+    std::vector<double> values;
+    values.reserve(m_samples.size());
+    for (const FrameSample &sample : m_samples) {
+        values.push_back(sample.*field);
+    }
+
+    // Nearest rank.
+    const auto rank = static_cast<size_t>(std::ceil(fraction * static_cast<double>(values.size())));
+    const size_t index = std::min(values.size() - 1, rank == 0 ? 0 : rank - 1);
+    std::nth_element(values.begin(), values.begin() + static_cast<ptrdiff_t>(index), values.end());
+    return values[index];
+}
+
+double FrameLog::mean(double FrameSample::*field) const {
+    if (m_samples.empty()) {
+        return 0.0;
+    }
+
+    double sum = 0.0;
+    for (const FrameSample &sample : m_samples) {
+        sum += sample.*field;
+    }
+
+    return sum / static_cast<double>(m_samples.size());
+}
+
+void FrameLog::summary(std::ostream &stream) const {
+    const std::pair<const char *, double FrameSample::*> fields[] = {
+        {"cpu", &FrameSample::cpu}, {"present", &FrameSample::present}, {"cast", &FrameSample::cast}
+    };
+
+    stream << m_samples.size() << " frames (ms)\n";
+    for (const auto &[name, field] : fields) {
+        stream << "  " << std::left << std::setw(8) << name << std::right << std::fixed << std::setprecision(3)
+               << " mean " << mean(field) << "  p50 " << percentile(field, 0.5) << "  p90 " << percentile(field, 0.9)
+               << "  p99 " << percentile(field, 0.99) << "  max " << percentile(field, 1.0) << '\n';
+    }
+
+    stream.unsetf(std::ios::fixed);
+    stream << std::setprecision(6) << std::flush;
+}
+
+void FrameLog::writeCsv(const std::string &path) const {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        throw std::exception("Could not open timings file.");
+    }
+
+    file << "frame,cpu_ms,present_ms,cast_ms,rays,segment_tests,draw_calls\n";
+    for (const FrameSample &sample : m_samples) {
+        file << sample.frame << ',' << sample.cpu << ',' << sample.present << ',' << sample.cast << ','
+             << sample.rays << ',' << sample.segmentTests << ',' << sample.drawCalls << '\n';
+    }
+}
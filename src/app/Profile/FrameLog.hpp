@@ -0,0 +1,43 @@
+#pragma once
+
+#include "pch.hpp"
+
+
+struct FrameSample {
+    uint64_t frame = 0;
+
+    // Milliseconds from the start of the frame until the draws were submitted and until swap returned.
+    double cpu = 0.0;
+    double present = 0.0;
+
+    // Milliseconds spent casting on the render thread, or by the worker for the result used this frame.
+    double cast = 0.0;
+
+    uint64_t rays = 0;
+    uint64_t segmentTests = 0;
+    uint32_t drawCalls = 0;
+};
+
+
+/* ****** Frame Log ******
+* Keeps a sample per presented frame so runs can be compared offline.
+*/
+class FrameLog {
+    std::vector<FrameSample> m_samples;
+
+public:
+    void record(const FrameSample &sample);
+
+    [[nodiscard]] const std::vector<FrameSample> &samples() const;
+
+    // The sample at the given fraction of the sorted values of one field, e.g. percentile(&FrameSample::cpu, 0.99).
+    [[nodiscard]] double percentile(double FrameSample::*field, double fraction) const;
+
+    [[nodiscard]] double mean(double FrameSample::*field) const;
+
+    // Mean and percentiles of the CPU, present and cast times.
+    void summary(std::ostream &stream) const;
+
+    // One header row, then one row per frame.
+    void writeCsv(const std::string &path) const;
+};
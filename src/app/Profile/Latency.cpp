@@ -0,0 +1,96 @@
+#include "pch.hpp"
+#include "Latency.hpp"
+
+
+/* ****** Latency Histogram ****** */
+void LatencyHistogram::record(double milliseconds) {
+    const auto bucket = static_cast<size_t>(std::max(0.0, milliseconds) / bucketWidth);
+    m_buckets[std::min(bucket, bucketCount - 1)]++;
+    m_count++;
+    m_sum += milliseconds;
+    m_max = std::max(m_max, milliseconds);
+}
+
+double LatencyHistogram::percentile(double fraction) const {
+    const auto target = static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(m_count)));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < bucketCount; i++) {
+        seen += m_buckets[i];
+        if (seen >= target && seen != 0) {
+            return static_cast<double>(i + 1) * bucketWidth;
+        }
+    }
+
+    return static_cast<double>(bucketCount) * bucketWidth;
+}
+
+double LatencyHistogram::mean() const {
+    return m_count != 0 ? m_sum / static_cast<double>(m_count) : 0.0;
+}
+
+double LatencyHistogram::max() const {
+    return m_max;
+}
+
+uint64_t LatencyHistogram::count() const {
+    return m_count;
+}
+
+void LatencyHistogram::print(std::ostream &stream, const char *name) const {
+    stream << name << ": " << m_count << " samples, mean " << mean() << "ms, p50 " << percentile(0.5)
+           << "ms, p90 " << percentile(0.9) << "ms, p99 " << percentile(0.99) << "ms, max " << m_max << "ms\n";
+
+    if (m_count == 0) {
+        return;
+    }
+
+    const uint64_t tallest = *std::max_element(m_buckets.begin(), m_buckets.end());
+    constexpr uint64_t barWidth = 40;
+    for (size_t i = 0; i < bucketCount; i++) {
+        if (m_buckets[i] == 0) {
+            continue;
+        }
+
+        const bool last = i == bucketCount - 1;
+        stream << "  " << (last ? ">" : "<") << std::setw(6) << static_cast<double>(last ? i : i + 1) * bucketWidth
+               << "ms " << std::string(std::max<uint64_t>(1, m_buckets[i] * barWidth / tallest), '#')
+               << ' ' << m_buckets[i] << '\n';
+    }
+}
+
+
+/* ****** Latency Tracker ****** */
+double LatencyTracker::elapsed(Clock::time_point time) const {
+    return std::chrono::duration<double, std::milli>(time - m_input.value()).count();
+}
+
+void LatencyTracker::input(Clock::time_point time) {
+    m_input = time;
+}
+
+void LatencyTracker::cast(Clock::time_point time) {
+    if (m_input.has_value()) {
+        m_cast.record(elapsed(time));
+    }
+}
+
+void LatencyTracker::upload(Clock::time_point time) {
+    if (m_input.has_value()) {
+        m_upload.record(elapsed(time));
+    }
+}
+
+void LatencyTracker::present(Clock::time_point time) {
+    if (m_input.has_value()) {
+        m_present.record(elapsed(time));
+        m_input.reset();
+    }
+}
+
+void LatencyTracker::print(std::ostream &stream) const {
+    stream << "Input latency\n";
+    m_cast.print(stream, "  to cast");
+    m_upload.print(stream, "  to upload");
+    m_present.print(stream, "  to present");
+    stream << std::flush;
+}
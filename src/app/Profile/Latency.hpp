@@ -0,0 +1,64 @@
+#pragma once
+
+#include "pch.hpp"
+
+
+// Fixed width buckets in milliseconds. Samples past the last bucket are counted in it.
+class LatencyHistogram {
+    static constexpr double bucketWidth = 0.5;
+    static constexpr size_t bucketCount = 128;
+
+    std::array<uint64_t, bucketCount> m_buckets{};
+    uint64_t m_count = 0;
+    double m_sum = 0.0;
+    double m_max = 0.0;
+
+public:
+    void record(double milliseconds);
+
+    // The upper edge of the bucket holding the given fraction of samples.
+    [[nodiscard]] double percentile(double fraction) const;
+
+    [[nodiscard]] double mean() const;
+
+    [[nodiscard]] double max() const;
+
+    [[nodiscard]] uint64_t count() const;
+
+    // Summary line followed by one bar per non-empty bucket.
+    void print(std::ostream &stream, const char *name) const;
+};
+
+
+/* ****** Latency Tracker ******
+* Follows one input sample through the frame and records how long after the input each stage finished.
+*
+* Usage:
+*   tracker.input(event.time);  // The input the frame is responding to.
+*   tracker.cast();             // After casting from it.
+*   tracker.upload();           // After its vertices reach the GPU.
+*   tracker.present();          // After the frame showing it is swapped.
+*/
+class LatencyTracker {
+    using Clock = std::chrono::steady_clock;
+
+    std::optional<Clock::time_point> m_input;
+
+    LatencyHistogram m_cast;
+    LatencyHistogram m_upload;
+    LatencyHistogram m_present;
+
+    [[nodiscard]] double elapsed(Clock::time_point time) const;
+
+public:
+    void input(Clock::time_point time);
+
+    void cast(Clock::time_point time = Clock::now());
+
+    void upload(Clock::time_point time = Clock::now());
+
+    // Completes the sample. Stages without a pending input are ignored.
+    void present(Clock::time_point time = Clock::now());
+
+    void print(std::ostream &stream) const;
+};
@@ -0,0 +1,107 @@
+#include "pch.hpp"
+#include "Trace.hpp"
+
+#ifdef RAY_CASTING_TRACE
+
+using TraceClock = std::chrono::steady_clock;
+
+
+// Buffers are owned here rather than by their threads so a thread that exits
+//   before the trace is written still has its events exported.
+static std::mutex registryMutex;
+static std::vector<std::unique_ptr<TraceBuffer>> registry;
+
+static TraceBuffer &threadBuffer() {
+    thread_local TraceBuffer *buffer = [] {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        registry.push_back(std::make_unique<TraceBuffer>(static_cast<uint32_t>(registry.size())));
+        return registry.back().get();
+    }();
+
+    return *buffer;
+}
+
+static uint64_t now() {
+    static const TraceClock::time_point epoch = TraceClock::now();
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(TraceClock::now() - epoch).count()
+    );
+}
+
+
+/* ****** Trace Buffer ****** */
+TraceBuffer::TraceBuffer(uint32_t thread) : m_events(new TraceEvent[capacity]), thread(thread) {}
+
+void TraceBuffer::push(const TraceEvent &event) {
+    const size_t count = m_count.load(std::memory_order_relaxed);
+    if (count == capacity) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    m_events[count] = event;
+    m_count.store(count + 1, std::memory_order_release);
+}
+
+size_t TraceBuffer::size() const {
+    return m_count.load(std::memory_order_acquire);
+}
+
+const TraceEvent &TraceBuffer::operator[](size_t index) const {
+    return m_events[index];
+}
+
+uint64_t TraceBuffer::dropped() const {
+    return m_dropped.load(std::memory_order_relaxed);
+}
+
+
+/* ****** Trace Scope ****** */
+TraceScope::TraceScope(const char *name) : m_name(name), m_start(now()) {}
+
+TraceScope::~TraceScope() {
+    threadBuffer().push({m_name, m_start, now() - m_start});
+}
+
+
+void traceThread(const char *name) {
+    threadBuffer().name.store(name, std::memory_order_relaxed);
+}
+
+void writeTrace(const char *path) {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        throw std::exception("Could not open trace file.");
+    }
+
+    // Chrome trace event format. Times are in microseconds.
+    file << "{\"traceEvents\":[\n";
+    file << std::fixed << std::setprecision(3);
+
+    bool first = true;
+    uint64_t dropped = 0;
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (const std::unique_ptr<TraceBuffer> &buffer : registry) {
+        if (const char *name = buffer->name.load(std::memory_order_relaxed)) {
+            file << (first ? "" : ",\n") << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << buffer->thread
+                 << R"(,"args":{"name":")" << name << "\"}}";
+            first = false;
+        }
+
+        const size_t count = buffer->size();
+        for (size_t i = 0; i < count; i++) {
+            const TraceEvent &event = (*buffer)[i];
+            file << (first ? "" : ",\n") << R"({"name":")" << event.name << R"(","ph":"X","pid":1,"tid":)"
+                 << buffer->thread << ",\"ts\":" << static_cast<double>(event.start) * 0.001
+                 << ",\"dur\":" << static_cast<double>(event.duration) * 0.001 << '}';
+            first = false;
+        }
+
+        dropped += buffer->dropped();
+    }
+
+    file << "\n]}\n";
+    std::cout << "Wrote trace to " << path << ", " << dropped << " events dropped." << std::endl;
+}
+
+#endif
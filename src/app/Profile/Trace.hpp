@@ -0,0 +1,92 @@
+#pragma once
+
+#include "pch.hpp"
+
+// Scoped CPU tracing. Build with RAY_CASTING_TRACE to record, otherwise every macro
+//   below expands to nothing and none of the tracing code is compiled.
+//
+// Usage:
+//   {
+//       TRACE_SCOPE("look");
+//       caster->look(bounds);
+//   }
+//   TRACE_WRITE("trace.json");  // Open in chrome://tracing or ui.perfetto.dev.
+#ifdef RAY_CASTING_TRACE
+
+#define TRACE_JOIN_(a, b) a##b
+#define TRACE_JOIN(a, b) TRACE_JOIN_(a, b)
+
+#define TRACE_SCOPE(name) const TraceScope TRACE_JOIN(traceScope, __LINE__)(name)
+#define TRACE_THREAD(name) traceThread(name)
+#define TRACE_WRITE(path) writeTrace(path)
+
+
+struct TraceEvent {
+    const char *name;
+
+    // Nanoseconds since the first event of the process.
+    uint64_t start;
+    uint64_t duration;
+};
+
+
+/* ****** Trace Buffer ******
+* A fixed capacity log of one thread's events.
+*
+* Only the owning thread appends, and it publishes each event with a release store of the count,
+*   so an export on another thread can read everything below the count without locking.
+*   Events past the capacity are counted and dropped rather than allocated.
+*/
+class TraceBuffer {
+    static constexpr size_t capacity = 1 << 16;
+
+    std::unique_ptr<TraceEvent[]> m_events;
+    std::atomic<size_t> m_count{0};
+    std::atomic<uint64_t> m_dropped{0};
+
+public:
+    const uint32_t thread;
+    std::atomic<const char *> name{nullptr};
+
+    explicit TraceBuffer(uint32_t thread);
+
+    // Owning thread only.
+    void push(const TraceEvent &event);
+
+    [[nodiscard]] size_t size() const;
+
+    [[nodiscard]] const TraceEvent &operator[](size_t index) const;
+
+    [[nodiscard]] uint64_t dropped() const;
+};
+
+
+class TraceScope {
+    const char *m_name;
+    uint64_t m_start;
+
+public:
+    // The name must outlive the trace, so pass a string literal.
+    explicit TraceScope(const char *name);
+
+    TraceScope(const TraceScope &other) = delete;
+
+    TraceScope &operator=(const TraceScope &other) = delete;
+
+    ~TraceScope();
+};
+
+
+// Label the calling thread in the exported trace.
+void traceThread(const char *name);
+
+// Write every thread's events as Chrome trace event JSON.
+void writeTrace(const char *path);
+
+#else
+
+#define TRACE_SCOPE(name) static_cast<void>(0)
+#define TRACE_THREAD(name) static_cast<void>(0)
+#define TRACE_WRITE(path) static_cast<void>(0)
+
+#endif
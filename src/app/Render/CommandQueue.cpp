@@ -0,0 +1,155 @@
+#include "pch.hpp"
+#include "CommandQueue.hpp"
+
+// Key layout, most significant first. The most expensive state to change sits highest
+//   so that it changes least often once the packets are sorted.
+//   | layer: 8 | blend: 4 | program: 16 | texture: 16 | vertex array: 20 |
+static constexpr uint64_t layerShift = 56;
+static constexpr uint64_t blendShift = 52;
+static constexpr uint64_t programShift = 36;
+static constexpr uint64_t textureShift = 20;
+static constexpr uint64_t vertexArrayShift = 0;
+
+static constexpr uint64_t mask(uint64_t bits) {
+    return (uint64_t(1) << bits) - 1;
+}
+
+
+uint64_t CommandQueue::sortKey(const Material &material, const DrawCall &call) {
+    const uint64_t program = material.program->id();
+    const uint64_t texture = material.texture != nullptr ? material.texture->id() : 0;
+    const uint64_t vertexArray = call.vao->id();
+
+    return (uint64_t(material.layer) << layerShift)
+           | ((uint64_t(material.blend) & mask(4)) << blendShift)
+           | ((program & mask(16)) << programShift)
+           | ((texture & mask(16)) << textureShift)
+           | ((vertexArray & mask(20)) << vertexArrayShift);
+}
+
+void CommandQueue::applyBlend(BlendMode mode) {
+    switch (mode) {
+        case BlendMode::Opaque: glDisable(GL_BLEND);
+            break;
+        case BlendMode::Alpha: glEnable(GL_BLEND);
+            glBlendEquation(GL_FUNC_ADD);
+            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+            break;
+        case BlendMode::Additive: glEnable(GL_BLEND);
+            glBlendEquation(GL_FUNC_ADD);
+            glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+            break;
+        case BlendMode::Lighten: glEnable(GL_BLEND);
+            glBlendEquation(GL_MAX);
+            break;
+        case BlendMode::Darken: glEnable(GL_BLEND);
+            glBlendEquation(GL_MIN);
+            break;
+    }
+}
+
+void CommandQueue::sort() {
+    // LSD radix sort, one byte per pass. Stable, so equal keys keep their recorded order.
+    const size_t count = m_packets.size();
+    m_scratch.resize(count);
+
+    for (uint64_t shift = 0; shift < 64; shift += 8) {
+        std::array<size_t, 256> offsets{};
+        for (const Packet &packet : m_packets) {
+            offsets[(packet.key >> shift) & 0xFF]++;
+        }
+
+        // Every key shares this byte, so the pass would not move anything.
+        if (offsets[(m_packets[0].key >> shift) & 0xFF] == count) {
+            continue;
+        }
+
+        size_t total = 0;
+        for (size_t &offset : offsets) {
+            const size_t bucket = offset;
+            offset = total;
+            total += bucket;
+        }
+
+        for (const Packet &packet : m_packets) {
+            m_scratch[offsets[(packet.key >> shift) & 0xFF]++] = packet;
+        }
+
+        std::swap(m_packets, m_scratch);
+    }
+}
+
+void CommandQueue::record(const Material &material, const DrawCall &call) {
+    // submit binds every packet's program, and a draw without one has nothing to run.
+    if (material.program == nullptr) {
+        throw std::exception("Cannot record a draw without a shader program.");
+    }
+
+    m_packets.push_back({sortKey(material, call), material, call});
+}
+
+void CommandQueue::submit() {
+    m_metrics = RenderMetrics();
+    if (m_packets.empty()) {
+        return;
+    }
+
+    sort();
+
+    // Nothing is assumed about the state left by the previous frame.
+    const lwvl::ShaderProgram *program = nullptr;
+    const lwvl::Texture2D *texture = nullptr;
+    const lwvl::VertexArray *vertexArray = nullptr;
+    std::optional<BlendMode> blend;
+
+    for (const Packet &packet : m_packets) {
+        const Material &material = packet.material;
+
+        // State changes belong to the draw they are made for, so they are timed with it.
+        const bool timed = m_timer != nullptr && material.name != nullptr;
+        if (timed) {
+            m_timer->begin(material.name);
+        }
+
+        if (program == nullptr || material.program->id() != program->id()) {
+            program = material.program;
+            material.program->bind();
+            m_metrics.stateChanges++;
+        }
+
+        if (material.texture != nullptr && material.texture != texture) {
+            texture = material.texture;
+            material.texture->bind();
+            m_metrics.stateChanges++;
+        }
+
+        if (!blend.has_value() || material.blend != blend.value()) {
+            blend = material.blend;
+            applyBlend(material.blend);
+            m_metrics.stateChanges++;
+        }
+
+        // DrawCall::execute binds the vertex array, which lwvl skips when it is already bound.
+        if (packet.call.vao != vertexArray) {
+            vertexArray = packet.call.vao;
+            m_metrics.stateChanges++;
+        }
+
+        packet.call.execute();
+        m_metrics.drawCalls++;
+
+        if (timed) {
+            m_timer->end();
+        }
+    }
+
+    m_packets.clear();
+}
+
+void CommandQueue::profile(lwvl::debug::GpuTimer *timer) {
+    m_timer = timer;
+}
+
+const RenderMetrics &CommandQueue::metrics() const {
+    return m_metrics;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "pch.hpp"
+#include "DrawCall.hpp"
+#include "Shader.hpp"
+#include "Texture.hpp"
+#include "Timer.hpp"
+
+
+// Lighten and Darken keep the brighter or the darker of the source and destination, so draws that overlap
+//   combine the same way in any order.
+enum class BlendMode : uint8_t {
+    Opaque = 0,
+    Alpha = 1,
+    Additive = 2,
+    Lighten = 3,
+    Darken = 4
+};
+
+
+// The state half of a draw.
+struct Material {
+    // Required. The texture may be left out.
+    lwvl::ShaderProgram *program = nullptr;
+    lwvl::Texture2D *texture = nullptr;
+    BlendMode blend = BlendMode::Opaque;
+
+    // Layers are drawn in ascending order. State is only sorted within a layer.
+    uint8_t layer = 0;
+
+    // Draws with a name are timed on the GPU when the queue has a timer.
+    const char *name = nullptr;
+};
+
+
+struct RenderMetrics {
+    uint32_t drawCalls = 0;
+    uint32_t stateChanges = 0;
+};
+
+
+/* ****** Command Queue ******
+* Records draws for a frame and submits them sorted by state, so each program, texture,
+*   vertex array and blend mode is only set when it actually changes.
+*
+* Usage:
+*   queue.record({&floorControl, &floorTexture, BlendMode::Opaque, 0}, floor.drawCall());
+*   queue.record({&lightControl, &floorTexture, BlendMode::Alpha, 1}, caster->drawCall());
+*   queue.submit();
+*/
+class CommandQueue {
+    struct Packet {
+        uint64_t key;
+        Material material;
+        DrawCall call;
+    };
+
+    std::vector<Packet> m_packets;
+    std::vector<Packet> m_scratch;
+    RenderMetrics m_metrics;
+    lwvl::debug::GpuTimer *m_timer = nullptr;
+
+    static uint64_t sortKey(const Material &material, const DrawCall &call);
+
+    static void applyBlend(BlendMode mode);
+
+    void sort();
+
+public:
+    // Throws when the material has no program.
+    void record(const Material &material, const DrawCall &call);
+
+    // Sort and execute every recorded draw, then empty the queue.
+    void submit();
+
+    // Time named draws with timer, or stop timing with nullptr.
+    void profile(lwvl::debug::GpuTimer *timer);
+
+    // Metrics for the most recent submit.
+    [[nodiscard]] const RenderMetrics &metrics() const;
+};
@@ -0,0 +1,49 @@
+#include "pch.hpp"
+#include "DrawCall.hpp"
+
+
+DrawCall DrawCall::arrays(lwvl::VertexArray &vao, lwvl::PrimitiveMode mode, int32_t count, int32_t first) {
+    DrawCall call;
+    call.vao = &vao;
+    call.mode = mode;
+    call.count = count;
+    call.first = first;
+    return call;
+}
+
+DrawCall DrawCall::multiArrays(lwvl::VertexArray &vao, lwvl::PrimitiveMode mode, int32_t count, int32_t draws) {
+    DrawCall call = arrays(vao, mode, count);
+    call.draws = draws;
+    return call;
+}
+
+DrawCall DrawCall::elements(
+    lwvl::VertexArray &vao, lwvl::PrimitiveMode mode, int32_t count, lwvl::ByteFormat format
+) {
+    DrawCall call;
+    call.vao = &vao;
+    call.mode = mode;
+    call.count = count;
+    call.indexed = true;
+    call.indexFormat = format;
+    return call;
+}
+
+void DrawCall::execute() const {
+    vao->bind();
+    if (indexed) {
+        vao->drawElements(mode, count, indexFormat);
+    } else if (draws > 1 || first != 0) {
+        std::array<GLint, maxDraws> firsts{};
+        std::array<GLsizei, maxDraws> counts{};
+        const int32_t runs = std::min(draws, maxDraws);
+        for (int32_t i = 0; i < runs; i++) {
+            firsts[i] = first + i * count;
+            counts[i] = count;
+        }
+
+        vao->multiDrawArrays(mode, firsts.data(), counts.data(), runs);
+    } else {
+        vao->drawArrays(mode, count);
+    }
+}
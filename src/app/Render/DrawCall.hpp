@@ -0,0 +1,33 @@
+#pragma once
+
+#include "pch.hpp"
+#include "VertexArray.hpp"
+
+// The geometry half of a draw: which vertex array to draw and how much of it.
+struct DrawCall {
+    static constexpr int32_t maxDraws = 64;
+
+    lwvl::VertexArray *vao = nullptr;
+    lwvl::PrimitiveMode mode = lwvl::PrimitiveMode::Triangles;
+    int32_t count = 0;
+
+    // Consecutive runs of count vertices drawn as separate primitives in one call, e.g. one fan per light sample.
+    int32_t draws = 1;
+
+    // The vertex the first run starts at. Arrays only.
+    int32_t first = 0;
+
+    // drawElements is used when indexed, drawArrays otherwise.
+    bool indexed = false;
+    lwvl::ByteFormat indexFormat = lwvl::ByteFormat::UnsignedInt;
+
+    static DrawCall arrays(lwvl::VertexArray &vao, lwvl::PrimitiveMode mode, int32_t count, int32_t first = 0);
+
+    // Arrays only.
+    static DrawCall multiArrays(lwvl::VertexArray &vao, lwvl::PrimitiveMode mode, int32_t count, int32_t draws);
+
+    static DrawCall elements(lwvl::VertexArray &vao, lwvl::PrimitiveMode mode, int32_t count, lwvl::ByteFormat format);
+
+    // Issue the draw. Binds the vertex array, the caller is responsible for everything else.
+    void execute() const;
+};
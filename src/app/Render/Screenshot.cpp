@@ -0,0 +1,22 @@
+#include "pch.hpp"
+#include "Screenshot.hpp"
+
+
+void writeScreenshot(const std::string &path, int32_t width, int32_t height) {
+    const auto rowSize = static_cast<size_t>(width) * 3;
+    std::vector<uint8_t> pixels(rowSize * static_cast<size_t>(height));
+
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::exception("Could not open screenshot file.");
+    }
+
+    // GL rows start at the bottom.
+    file << "P6\n" << width << ' ' << height << "\n255\n";
+    for (int32_t row = height - 1; row >= 0; row--) {
+        file.write(reinterpret_cast<const char *>(pixels.data() + static_cast<size_t>(row) * rowSize), rowSize);
+    }
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+#include "pch.hpp"
+
+
+// Read the bound read framebuffer and write it as a binary PPM, top row first.
+void writeScreenshot(const std::string &path, int32_t width, int32_t height);
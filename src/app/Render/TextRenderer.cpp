@@ -0,0 +1,240 @@
+#include "pch.hpp"
+#include "TextRenderer.hpp"
+
+static constexpr uint32_t glyphWidth = 5;
+static constexpr uint32_t glyphHeight = 7;
+
+// Glyphs are packed into cells one pixel larger than the glyph so linear filtering
+//   or rounding never pulls in a neighbour.
+static constexpr uint32_t cellWidth = glyphWidth + 1;
+static constexpr uint32_t cellHeight = glyphHeight + 1;
+static constexpr uint32_t atlasColumns = 16;
+static constexpr uint32_t atlasRows = 6;
+static constexpr uint32_t atlasWidth = atlasColumns * cellWidth;
+static constexpr uint32_t atlasHeight = atlasRows * cellHeight;
+
+static constexpr char firstGlyph = ' ';
+static constexpr char lastGlyph = '~';
+
+// Columns from left to right, least significant bit at the top.
+static constexpr uint8_t font[][glyphWidth] = {
+    {0x00, 0x00, 0x00, 0x00, 0x00},  // ' '
+    {0x00, 0x00, 0x5F, 0x00, 0x00},  // !
+    {0x00, 0x07, 0x00, 0x07, 0x00},  // "
+    {0x14, 0x7F, 0x14, 0x7F, 0x14},  // #
+    {0x24, 0x2A, 0x7F, 0x2A, 0x12},  // $
+    {0x23, 0x13, 0x08, 0x64, 0x62},  // %
+    {0x36, 0x49, 0x55, 0x22, 0x50},  // &
+    {0x00, 0x05, 0x03, 0x00, 0x00},  // '
+    {0x00, 0x1C, 0x22, 0x41, 0x00},  // (
+    {0x00, 0x41, 0x22, 0x1C, 0x00},  // )
+    {0x08, 0x2A, 0x1C, 0x2A, 0x08},  // *
+    {0x08, 0x08, 0x3E, 0x08, 0x08},  // +
+    {0x00, 0x50, 0x30, 0x00, 0x00},  // ,
+    {0x08, 0x08, 0x08, 0x08, 0x08},  // -
+    {0x00, 0x60, 0x60, 0x00, 0x00},  // .
+    {0x20, 0x10, 0x08, 0x04, 0x02},  // /
+    {0x3E, 0x51, 0x49, 0x45, 0x3E},  // 0
+    {0x00, 0x42, 0x7F, 0x40, 0x00},  // 1
+    {0x42, 0x61, 0x51, 0x49, 0x46},  // 2
+    {0x21, 0x41, 0x45, 0x4B, 0x31},  // 3
+    {0x18, 0x14, 0x12, 0x7F, 0x10},  // 4
+    {0x27, 0x45, 0x45, 0x45, 0x39},  // 5
+    {0x3C, 0x4A, 0x49, 0x49, 0x30},  // 6
+    {0x01, 0x71, 0x09, 0x05, 0x03},  // 7
+    {0x36, 0x49, 0x49, 0x49, 0x36},  // 8
+    {0x06, 0x49, 0x49, 0x29, 0x1E},  // 9
+    {0x00, 0x36, 0x36, 0x00, 0x00},  // :
+    {0x00, 0x56, 0x36, 0x00, 0x00},  // ;
+    {0x08, 0x14, 0x22, 0x41, 0x00},  // <
+    {0x14, 0x14, 0x14, 0x14, 0x14},  // =
+    {0x00, 0x41, 0x22, 0x14, 0x08},  // >
+    {0x02, 0x01, 0x51, 0x09, 0x06},  // ?
+    {0x32, 0x49, 0x79, 0x41, 0x3E},  // @
+    {0x7E, 0x11, 0x11, 0x11, 0x7E},  // A
+    {0x7F, 0x49, 0x49, 0x49, 0x36},  // B
+    {0x3E, 0x41, 0x41, 0x41, 0x22},  // C
+    {0x7F, 0x41, 0x41, 0x22, 0x1C},  // D
+    {0x7F, 0x49, 0x49, 0x49, 0x41},  // E
+    {0x7F, 0x09, 0x09, 0x09, 0x01},  // F
+    {0x3E, 0x41, 0x49, 0x49, 0x7A},  // G
+    {0x7F, 0x08, 0x08, 0x08, 0x7F},  // H
+    {0x00, 0x41, 0x7F, 0x41, 0x00},  // I
+    {0x20, 0x40, 0x41, 0x3F, 0x01},  // J
+    {0x7F, 0x08, 0x14, 0x22, 0x41},  // K
+    {0x7F, 0x40, 0x40, 0x40, 0x40},  // L
+    {0x7F, 0x02, 0x0C, 0x02, 0x7F},  // M
+    {0x7F, 0x04, 0x08, 0x10, 0x7F},  // N
+    {0x3E, 0x41, 0x41, 0x41, 0x3E},  // O
+    {0x7F, 0x09, 0x09, 0x09, 0x06},  // P
+    {0x3E, 0x41, 0x51, 0x21, 0x5E},  // Q
+    {0x7F, 0x09, 0x19, 0x29, 0x46},  // R
+    {0x46, 0x49, 0x49, 0x49, 0x31},  // S
+    {0x01, 0x01, 0x7F, 0x01, 0x01},  // T
+    {0x3F, 0x40, 0x40, 0x40, 0x3F},  // U
+    {0x1F, 0x20, 0x40, 0x20, 0x1F},  // V
+    {0x3F, 0x40, 0x38, 0x40, 0x3F},  // W
+    {0x63, 0x14, 0x08, 0x14, 0x63},  // X
+    {0x07, 0x08, 0x70, 0x08, 0x07},  // Y
+    {0x61, 0x51, 0x49, 0x45, 0x43},  // Z
+    {0x00, 0x7F, 0x41, 0x41, 0x00},  // [
+    {0x02, 0x04, 0x08, 0x10, 0x20},  // backslash
+    {0x00, 0x41, 0x41, 0x7F, 0x00},  // ]
+    {0x04, 0x02, 0x01, 0x02, 0x04},  // ^
+    {0x40, 0x40, 0x40, 0x40, 0x40},  // _
+    {0x00, 0x01, 0x02, 0x04, 0x00},  // `
+    {0x20, 0x54, 0x54, 0x54, 0x78},  // a
+    {0x7F, 0x48, 0x44, 0x44, 0x38},  // b
+    {0x38, 0x44, 0x44, 0x44, 0x20},  // c
+    {0x38, 0x44, 0x44, 0x48, 0x7F},  // d
+    {0x38, 0x54, 0x54, 0x54, 0x18},  // e
+    {0x08, 0x7E, 0x09, 0x01, 0x02},  // f
+    {0x0C, 0x52, 0x52, 0x52, 0x3E},  // g
+    {0x7F, 0x08, 0x04, 0x04, 0x78},  // h
+    {0x00, 0x44, 0x7D, 0x40, 0x00},  // i
+    {0x20, 0x40, 0x44, 0x3D, 0x00},  // j
+    {0x7F, 0x10, 0x28, 0x44, 0x00},  // k
+    {0x00, 0x41, 0x7F, 0x40, 0x00},  // l
+    {0x7C, 0x04, 0x18, 0x04, 0x78},  // m
+    {0x7C, 0x08, 0x04, 0x04, 0x78},  // n
+    {0x38, 0x44, 0x44, 0x44, 0x38},  // o
+    {0x7C, 0x14, 0x14, 0x14, 0x08},  // p
+    {0x08, 0x14, 0x14, 0x18, 0x7C},  // q
+    {0x7C, 0x08, 0x04, 0x04, 0x08},  // r
+    {0x48, 0x54, 0x54, 0x54, 0x20},  // s
+    {0x04, 0x3F, 0x44, 0x40, 0x20},  // t
+    {0x3C, 0x40, 0x40, 0x20, 0x7C},  // u
+    {0x1C, 0x20, 0x40, 0x20, 0x1C},  // v
+    {0x3C, 0x40, 0x30, 0x40, 0x3C},  // w
+    {0x44, 0x28, 0x10, 0x28, 0x44},  // x
+    {0x0C, 0x50, 0x50, 0x50, 0x3C},  // y
+    {0x44, 0x64, 0x54, 0x4C, 0x44},  // z
+    {0x00, 0x08, 0x36, 0x41, 0x00},  // {
+    {0x00, 0x00, 0x7F, 0x00, 0x00},  // |
+    {0x00, 0x41, 0x36, 0x08, 0x00},  // }
+    {0x08, 0x04, 0x08, 0x10, 0x08},  // ~
+};
+
+static_assert(sizeof(font) / sizeof(font[0]) == lastGlyph - firstGlyph + 1, "Every printable character needs a glyph.");
+static_assert(atlasColumns * atlasRows >= lastGlyph - firstGlyph + 1, "The atlas is too small for the font.");
+
+
+TextRenderer::TextRenderer(float frameWidth, float frameHeight, uint32_t slot, float scale) :
+    m_frameHeight(frameHeight), m_scale(scale) {
+    // Rasterize the font into the atlas, top row of each glyph first.
+    std::vector<uint8_t> pixels(atlasWidth * atlasHeight, 0);
+    for (uint32_t glyph = 0; glyph <= static_cast<uint32_t>(lastGlyph - firstGlyph); glyph++) {
+        const uint32_t left = (glyph % atlasColumns) * cellWidth;
+        const uint32_t top = (glyph / atlasColumns) * cellHeight;
+
+        for (uint32_t column = 0; column < glyphWidth; column++) {
+            for (uint32_t row = 0; row < glyphHeight; row++) {
+                if (font[glyph][column] & (1u << row)) {
+                    pixels[(top + row) * atlasWidth + left + column] = 0xFF;
+                }
+            }
+        }
+    }
+
+    m_atlas.slot(slot);
+    m_atlas.construct(
+        atlasWidth, atlasHeight, pixels.data(),
+        lwvl::ChannelLayout::Red, lwvl::ChannelOrder::Red, lwvl::ByteFormat::UnsignedByte
+    );
+    m_atlas.filter(lwvl::Filter::Nearest);
+
+    m_control.link(
+        lwvl::VertexShader::readFile("Data/Shaders/text.vert"),
+        lwvl::FragmentShader::readFile("Data/Shaders/text.frag")
+    );
+    m_control.uniform("u_Projection").set2DOrthographic(frameHeight, 0.0f, frameWidth, 0.0f);
+    m_control.uniform("u_Texture").set1i(static_cast<int32_t>(slot));
+
+    m_vbo.usage(lwvl::Usage::Stream);
+    m_vao.attribute(m_vbo, 2, GL_FLOAT, 4 * sizeof(float), 0);
+    m_vao.attribute(m_vbo, 2, GL_FLOAT, 4 * sizeof(float), 2 * sizeof(float));
+}
+
+void TextRenderer::begin() {
+    m_vertices.clear();
+}
+
+void TextRenderer::add(float x, float y, std::string_view text) {
+    const float width = static_cast<float>(glyphWidth) * m_scale;
+    const float height = static_cast<float>(glyphHeight) * m_scale;
+    const float advance = static_cast<float>(cellWidth) * m_scale;
+
+    // Projection space has y pointing up.
+    float penX = x;
+    float penY = m_frameHeight - y;
+    for (char character : text) {
+        if (character == '\n') {
+            penX = x;
+            penY -= lineHeight();
+            continue;
+        }
+
+        if (character < firstGlyph || character > lastGlyph) {
+            character = '?';
+        }
+
+        if (character != ' ') {
+            const uint32_t glyph = static_cast<uint32_t>(character - firstGlyph);
+            const float u0 = static_cast<float>((glyph % atlasColumns) * cellWidth) / atlasWidth;
+            const float v0 = static_cast<float>((glyph / atlasColumns) * cellHeight) / atlasHeight;
+            const float u1 = u0 + static_cast<float>(glyphWidth) / atlasWidth;
+            const float v1 = v0 + static_cast<float>(glyphHeight) / atlasHeight;
+
+            // The atlas rows were uploaded top first, so v0 is the top of the glyph.
+            const float left = penX, right = penX + width;
+            const float top = penY, bottom = penY - height;
+            m_vertices.insert(
+                m_vertices.end(), {
+                    left, bottom, u0, v1,
+                    right, bottom, u1, v1,
+                    right, top, u1, v0,
+                    right, top, u1, v0,
+                    left, top, u0, v0,
+                    left, bottom, u0, v1
+                }
+            );
+        }
+
+        penX += advance;
+    }
+}
+
+void TextRenderer::end() {
+    const size_t glyphs = m_vertices.size() / floatsPerGlyph;
+    if (glyphs > m_capacity) {
+        // Grow to the next power of two so a slowly lengthening string does not reallocate every frame.
+        m_capacity = std::max<size_t>(64, m_capacity);
+        while (m_capacity < glyphs) {
+            m_capacity *= 2;
+        }
+
+        m_vbo.construct<float>(nullptr, static_cast<GLsizei>(m_capacity * floatsPerGlyph));
+    }
+
+    if (!m_vertices.empty()) {
+        m_vbo.update(m_vertices.begin(), m_vertices.end());
+    }
+
+    m_count = static_cast<int32_t>(glyphs * 6);
+}
+
+float TextRenderer::lineHeight() const {
+    return static_cast<float>(cellHeight + 1) * m_scale;
+}
+
+lwvl::ShaderProgram &TextRenderer::program() {
+    return m_control;
+}
+
+lwvl::Texture2D &TextRenderer::atlas() {
+    return m_atlas;
+}
+
+DrawCall TextRenderer::drawCall() {
+    return DrawCall::arrays(m_vao, lwvl::PrimitiveMode::Triangles, m_count);
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "pch.hpp"
+#include "VertexArray.hpp"
+#include "Buffer.hpp"
+#include "Shader.hpp"
+#include "Texture.hpp"
+#include "DrawCall.hpp"
+
+
+/* ****** Text Renderer ******
+* Batches text into one vertex buffer and draws it from a single glyph atlas in one call.
+* The font is a built in 5x7 bitmap covering printable ASCII, scaled by whole pixels.
+*
+* Usage:
+*   text.begin();
+*   text.add(10.0f, 10.0f, "Frame 16.6ms");  // Pixels from the top left of the window.
+*   text.end();                             // Uploads the batch.
+*   queue.record({&text.program(), &text.atlas(), BlendMode::Alpha, 3}, text.drawCall());
+*/
+class TextRenderer {
+    static constexpr size_t floatsPerGlyph = 6 * 4;
+
+    lwvl::Texture2D m_atlas;
+    lwvl::ShaderProgram m_control;
+    lwvl::VertexArray m_vao;
+    lwvl::ArrayBuffer m_vbo;
+
+    std::vector<float> m_vertices;
+    size_t m_capacity = 0;
+    int32_t m_count = 0;
+
+    float m_frameHeight;
+    float m_scale;
+
+public:
+    // The atlas takes the given texture slot so it does not disturb textures already bound.
+    TextRenderer(float frameWidth, float frameHeight, uint32_t slot, float scale = 2.0f);
+
+    void begin();
+
+    // Characters outside printable ASCII are drawn as '?'. '\n' starts a new line under x.
+    void add(float x, float y, std::string_view text);
+
+    void end();
+
+    [[nodiscard]] float lineHeight() const;
+
+    lwvl::ShaderProgram &program();
+
+    lwvl::Texture2D &atlas();
+
+    DrawCall drawCall();
+};
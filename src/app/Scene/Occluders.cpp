@@ -0,0 +1,90 @@
+#include "pch.hpp"
+#include "Occluders.hpp"
+
+
+bool Occluders::facesAway(const LineSegment &edge, const Point &point) {
+    // The open side is on the right of the edge.
+    const float side = (edge.b.x - edge.a.x) * (point.y - edge.a.y) - (edge.b.y - edge.a.y) * (point.x - edge.a.x);
+    return side >= 0.0f;
+}
+
+bool Occluders::inside(uint32_t polygon, const Point &point) const {
+    const Polygon &shape = m_polygons[polygon];
+    if (point.x < shape.left || point.x > shape.right || point.y < shape.bottom || point.y > shape.top) {
+        return false;
+    }
+
+    // Counts the edges crossed by a ray from point towards +x.
+    bool crossed = false;
+    for (uint32_t i = shape.first; i < shape.first + shape.count; i++) {
+        const LineSegment &edge = m_segments[i];
+        if ((edge.a.y > point.y) != (edge.b.y > point.y)) {
+            const float x = edge.a.x + (point.y - edge.a.y) / (edge.b.y - edge.a.y) * (edge.b.x - edge.a.x);
+            crossed ^= point.x < x;
+        }
+    }
+
+    return crossed;
+}
+
+void Occluders::addPolygon(const std::vector<Point> &vertices) {
+    if (vertices.empty()) {
+        return;
+    }
+
+    Polygon shape{
+        static_cast<uint32_t>(m_segments.size()), static_cast<uint32_t>(vertices.size()),
+        vertices[0].x, vertices[0].y, vertices[0].x, vertices[0].y
+    };
+    const auto polygon = static_cast<uint32_t>(m_polygons.size());
+    for (size_t i = 0; i < vertices.size(); i++) {
+        m_segments.emplace_back(vertices[i], vertices[(i + 1) % vertices.size()]);
+        m_polygonOf.push_back(polygon);
+
+        shape.left = std::min(shape.left, vertices[i].x);
+        shape.bottom = std::min(shape.bottom, vertices[i].y);
+        shape.right = std::max(shape.right, vertices[i].x);
+        shape.top = std::max(shape.top, vertices[i].y);
+    }
+
+    m_polygons.push_back(shape);
+}
+
+void Occluders::addSegment(const LineSegment &segment) {
+    m_segments.push_back(segment);
+    m_polygonOf.push_back(LOOSE);
+}
+
+void Occluders::addSegments(const std::vector<LineSegment> &segments) {
+    m_segments.insert(m_segments.end(), segments.begin(), segments.end());
+    m_polygonOf.resize(m_segments.size(), LOOSE);
+}
+
+const std::vector<LineSegment> &Occluders::segments() const {
+    return m_segments;
+}
+
+bool Occluders::faces(size_t index, const Point &point) const {
+    const uint32_t polygon = m_polygonOf[index];
+    return polygon == LOOSE || !facesAway(m_segments[index], point) || inside(polygon, point);
+}
+
+void Occluders::cull(const Point &point, std::vector<LineSegment> &visible) const {
+    visible.clear();
+    size_t i = 0;
+    while (i < m_segments.size()) {
+        const uint32_t polygon = m_polygonOf[i];
+        if (polygon == LOOSE) {
+            visible.push_back(m_segments[i++]);
+            continue;
+        }
+
+        const Polygon &shape = m_polygons[polygon];
+        const bool enclosed = inside(polygon, point);
+        for (; i < shape.first + shape.count; i++) {
+            if (enclosed || !facesAway(m_segments[i], point)) {
+                visible.push_back(m_segments[i]);
+            }
+        }
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "pch.hpp"
+#include "Math/Geometrics.hpp"
+
+
+/* ****** Occluders ******
+* The walls of a level: edges of closed polygons, which can only be seen from one side,
+*   and loose segments, which can be seen from both.
+*
+* Polygons are given with the solid side on the left of every edge, i.e. counter clockwise around an obstacle
+*   and clockwise around a room. A ray from a light can only reach an edge's open side first, so an edge
+*   whose open side faces away from the light is never the nearest hit and can be skipped. That drops about
+*   half of every polygon, and the vertices between two skipped edges need no rays at all.
+*
+* That only holds for a light in the open. A light inside an obstacle sees the solid side of every edge around it,
+*   so the whole polygon is kept while the light is within it.
+*
+* Edges are stored in order around each polygon, so a caster sees the kept edges of a polygon as chains.
+*/
+class Occluders {
+    struct Polygon {
+        uint32_t first;
+        uint32_t count;
+        float left, bottom, right, top;
+    };
+
+    static constexpr uint32_t LOOSE = std::numeric_limits<uint32_t>::max();
+
+    std::vector<LineSegment> m_segments;
+
+    // Parallel to m_segments. The polygon each edge belongs to, or LOOSE.
+    std::vector<uint32_t> m_polygonOf;
+
+    std::vector<Polygon> m_polygons;
+
+    [[nodiscard]] bool inside(uint32_t polygon, const Point &point) const;
+
+    [[nodiscard]] static bool facesAway(const LineSegment &edge, const Point &point);
+
+public:
+    // Closes the polygon from the last vertex back to the first.
+    void addPolygon(const std::vector<Point> &vertices);
+
+    void addSegment(const LineSegment &segment);
+
+    void addSegments(const std::vector<LineSegment> &segments);
+
+    [[nodiscard]] const std::vector<LineSegment> &segments() const;
+
+    // Whether the segment at index could be hit by a ray from point.
+    //   An edge facing away from point costs a bounds check, and a walk around its polygon when point is within them.
+    [[nodiscard]] bool faces(size_t index, const Point &point) const;
+
+    // Replaces visible with the segments that face point, in order. Tests whether point is in each polygon only once.
+    void cull(const Point &point, std::vector<LineSegment> &visible) const;
+};
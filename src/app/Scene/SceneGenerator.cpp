@@ -0,0 +1,171 @@
+#include "pch.hpp"
+#include "SceneGenerator.hpp"
+#include "Math/FastTrig.hpp"
+
+static constexpr float TAU = 6.283185307179586f;
+
+
+/* ****** Scene Random ****** */
+SceneRandom::SceneRandom(uint64_t seed) : m_state(seed) {}
+
+uint64_t SceneRandom::next() {
+    uint64_t z = (m_state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+float SceneRandom::unit() {
+    // The top 24 bits fill a float's mantissa exactly.
+    return static_cast<float>(next() >> 40) * (1.0f / 16777216.0f);
+}
+
+float SceneRandom::range(float low, float high) {
+    return low + (high - low) * unit();
+}
+
+
+SceneKind parseSceneKind(std::string_view name) {
+    if (name == "maze") { return SceneKind::Maze; }
+    if (name == "soup") { return SceneKind::Soup; }
+    if (name == "city") { return SceneKind::City; }
+    if (name == "polygon") { return SceneKind::Polygon; }
+    throw std::exception("Unknown scene kind.");
+}
+
+const char *sceneKindName(SceneKind kind) {
+    switch (kind) {
+        case SceneKind::Maze:return "maze";
+        case SceneKind::Soup:return "soup";
+        case SceneKind::City:return "city";
+        case SceneKind::Polygon:return "polygon";
+    }
+
+    return "unknown";
+}
+
+
+// Pick a grid with about the given number of cells whose cells are roughly square.
+static std::pair<size_t, size_t> gridFor(size_t cells, float width, float height) {
+    const double aspect = static_cast<double>(width) / static_cast<double>(height);
+    const auto columns = std::max<size_t>(1, static_cast<size_t>(std::round(std::sqrt(static_cast<double>(cells) * aspect))));
+    const size_t rows = std::max<size_t>(1, (cells + columns - 1) / columns);
+    return {columns, rows};
+}
+
+static void maze(const SceneSpec &spec, SceneRandom &random, std::vector<LineSegment> &segments) {
+    const auto[columns, rows] = gridFor(spec.segments, spec.width, spec.height);
+    const float cellWidth = spec.width / static_cast<float>(columns);
+    const float cellHeight = spec.height / static_cast<float>(rows);
+
+    for (size_t row = 0; row < rows; row++) {
+        for (size_t column = 0; column < columns; column++) {
+            const float x0 = spec.left + static_cast<float>(column) * cellWidth;
+            const float y0 = spec.bottom + static_cast<float>(row) * cellHeight;
+            const float x1 = x0 + cellWidth;
+            const float y1 = y0 + cellHeight;
+
+            // Flip the diagonal on a coin toss, like the hash in mazing.frag.
+            if (random.next() & 1) {
+                segments.emplace_back(x0, y0, x1, y1);
+            } else {
+                segments.emplace_back(x0, y1, x1, y0);
+            }
+        }
+    }
+}
+
+static void soup(const SceneSpec &spec, SceneRandom &random, std::vector<LineSegment> &segments) {
+    // Scale lengths with the spacing between segments so density stays similar at any count.
+    const float spacing = std::sqrt(spec.width * spec.height / static_cast<float>(std::max<size_t>(1, spec.segments)));
+    const float longest = std::min(3.0f * spacing, 0.25f * std::min(spec.width, spec.height));
+
+    for (size_t i = 0; i < spec.segments; i++) {
+        const float x = random.range(spec.left, spec.left + spec.width);
+        const float y = random.range(spec.bottom, spec.bottom + spec.height);
+        const float angle = random.range(0.0f, TAU);
+        const float length = random.range(0.2f, 1.0f) * longest;
+
+        // libm's sine and cosine are not correctly rounded and differ between libraries, but the polynomial ones
+        //   are plain float arithmetic and come out the same everywhere.
+        float sine, cosine;
+        fastSinCos(angle, sine, cosine);
+        const float x1 = std::clamp(x + length * cosine, spec.left, spec.left + spec.width);
+        const float y1 = std::clamp(y + length * sine, spec.bottom, spec.bottom + spec.height);
+        segments.emplace_back(x, y, x1, y1);
+    }
+}
+
+static void city(const SceneSpec &spec, SceneRandom &random, std::vector<LineSegment> &segments) {
+    // Each block is four walls inside its own lot, leaving the rest of the lot as street.
+    const auto[columns, rows] = gridFor(std::max<size_t>(1, spec.segments / 4), spec.width, spec.height);
+    const float lotWidth = spec.width / static_cast<float>(columns);
+    const float lotHeight = spec.height / static_cast<float>(rows);
+
+    for (size_t row = 0; row < rows; row++) {
+        for (size_t column = 0; column < columns; column++) {
+            const float lotX = spec.left + static_cast<float>(column) * lotWidth;
+            const float lotY = spec.bottom + static_cast<float>(row) * lotHeight;
+
+            const float x0 = lotX + random.range(0.1f, 0.3f) * lotWidth;
+            const float y0 = lotY + random.range(0.1f, 0.3f) * lotHeight;
+            const float x1 = lotX + random.range(0.7f, 0.9f) * lotWidth;
+            const float y1 = lotY + random.range(0.7f, 0.9f) * lotHeight;
+
+            segments.emplace_back(x0, y0, x1, y0);
+            segments.emplace_back(x1, y0, x1, y1);
+            segments.emplace_back(x1, y1, x0, y1);
+            segments.emplace_back(x0, y1, x0, y0);
+        }
+    }
+}
+
+static void polygon(const SceneSpec &spec, SceneRandom &random, std::vector<LineSegment> &segments) {
+    // Vertices at increasing angles around the center can never cross, so the polygon stays simple.
+    const size_t vertices = std::max<size_t>(3, spec.segments);
+    const float centerX = spec.left + 0.5f * spec.width;
+    const float centerY = spec.bottom + 0.5f * spec.height;
+    const float radius = 0.45f * std::min(spec.width, spec.height);
+
+    std::vector<Point> points;
+    points.reserve(vertices);
+    for (size_t i = 0; i < vertices; i++) {
+        const float angle = TAU * static_cast<float>(i) / static_cast<float>(vertices);
+        const float r = radius * random.range(0.35f, 1.0f);
+
+        // Polynomial rather than libm for the same reason as in soup.
+        float sine, cosine;
+        fastSinCos(angle, sine, cosine);
+        points.emplace_back(centerX + r * cosine, centerY + r * sine);
+    }
+
+    for (size_t i = 0; i < vertices; i++) {
+        segments.emplace_back(points[i], points[(i + 1) % vertices]);
+    }
+}
+
+std::vector<LineSegment> generateScene(const SceneSpec &spec) {
+    SceneRandom random(spec.seed);
+    std::vector<LineSegment> segments;
+    segments.reserve(spec.segments + 4);
+
+    const float right = spec.left + spec.width;
+    const float top = spec.bottom + spec.height;
+    segments.emplace_back(spec.left, spec.bottom, right, spec.bottom);
+    segments.emplace_back(right, spec.bottom, right, top);
+    segments.emplace_back(right, top, spec.left, top);
+    segments.emplace_back(spec.left, top, spec.left, spec.bottom);
+
+    switch (spec.kind) {
+        case SceneKind::Maze:maze(spec, random, segments);
+            break;
+        case SceneKind::Soup:soup(spec, random, segments);
+            break;
+        case SceneKind::City:city(spec, random, segments);
+            break;
+        case SceneKind::Polygon:polygon(spec, random, segments);
+            break;
+    }
+
+    return segments;
+}
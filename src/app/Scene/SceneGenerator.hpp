@@ -0,0 +1,53 @@
+#pragma once
+
+#include "pch.hpp"
+#include "Math/Geometrics.hpp"
+
+
+enum class SceneKind {
+    Maze,     // One diagonal per grid cell, like the Truchet tiling in mazing.frag.
+    Soup,     // Segments of random position, direction and length.
+    City,     // Rectangular blocks separated by streets.
+    Polygon   // A single closed star shaped polygon.
+};
+
+
+struct SceneSpec {
+    SceneKind kind = SceneKind::Maze;
+    uint64_t seed = 1;
+
+    // Roughly how many segments to generate, not counting the frame.
+    size_t segments = 1000;
+
+    // The area to fill. A wall is always placed around its edge.
+    float left = 0.0f, bottom = 0.0f, width = 1.0f, height = 1.0f;
+};
+
+
+/* ****** Scene Random ******
+* SplitMix64. The standard distributions are not the same across standard libraries,
+*   so the generator does its own conversions to keep a seed producing the same scene everywhere.
+*   For the same reason scenes take their directions from fastSinCos rather than libm.
+*/
+class SceneRandom {
+    uint64_t m_state;
+
+public:
+    explicit SceneRandom(uint64_t seed);
+
+    uint64_t next();
+
+    // Uniform in [0, 1).
+    float unit();
+
+    // Uniform in [low, high).
+    float range(float low, float high);
+};
+
+
+// Parses "maze", "soup", "city" or "polygon". Throws on anything else.
+SceneKind parseSceneKind(std::string_view name);
+
+const char *sceneKindName(SceneKind kind);
+
+std::vector<LineSegment> generateScene(const SceneSpec &spec);
@@ -0,0 +1,139 @@
+#include "pch.hpp"
+#include "SegmentGrid.hpp"
+
+// Keeps the offsets of a degenerate or enormous level bounded.
+static constexpr uint32_t maxCellsPerSide = 1024;
+
+
+// The squared distance from point to the closest point of segment.
+static float squaredDistance(const Point &point, const LineSegment &segment) {
+    const float ex = segment.b.x - segment.a.x;
+    const float ey = segment.b.y - segment.a.y;
+    const float px = point.x - segment.a.x;
+    const float py = point.y - segment.a.y;
+
+    const float length = ex * ex + ey * ey;
+    const float along = length > 0.0f ? std::clamp((px * ex + py * ey) / length, 0.0f, 1.0f) : 0.0f;
+
+    const float dx = px - along * ex;
+    const float dy = py - along * ey;
+    return dx * dx + dy * dy;
+}
+
+
+uint32_t SegmentGrid::column(float x) const {
+    const float cell = std::floor((x - m_origin.x) / m_cellSize);
+    return static_cast<uint32_t>(std::clamp(cell, 0.0f, static_cast<float>(m_columns - 1)));
+}
+
+uint32_t SegmentGrid::row(float y) const {
+    const float cell = std::floor((y - m_origin.y) / m_cellSize);
+    return static_cast<uint32_t>(std::clamp(cell, 0.0f, static_cast<float>(m_rows - 1)));
+}
+
+template<typename Visit>
+void SegmentGrid::rasterize(const LineSegment &segment, Visit &&visit) const {
+    const Point &low = segment.a.y <= segment.b.y ? segment.a : segment.b;
+    const Point &high = segment.a.y <= segment.b.y ? segment.b : segment.a;
+    const float rise = high.y - low.y;
+
+    const uint32_t bottom = row(low.y);
+    const uint32_t top = row(high.y);
+    for (uint32_t y = bottom; y <= top; y++) {
+        // The part of the segment inside this row, padded so rounding cannot drop a cell it just touches.
+        float start = low.x;
+        float end = high.x;
+        if (rise > 0.0f) {
+            const float rowBottom = m_origin.y + static_cast<float>(y) * m_cellSize;
+            const float from = std::clamp((rowBottom - low.y) / rise, 0.0f, 1.0f);
+            const float to = std::clamp((rowBottom + m_cellSize - low.y) / rise, 0.0f, 1.0f);
+            start = low.x + from * (high.x - low.x);
+            end = low.x + to * (high.x - low.x);
+        }
+
+        const float padding = m_cellSize * 0.001f;
+        const uint32_t left = column(std::min(start, end) - padding);
+        const uint32_t right = column(std::max(start, end) + padding);
+        for (uint32_t x = left; x <= right; x++) {
+            visit(y * m_columns + x);
+        }
+    }
+}
+
+SegmentGrid::SegmentGrid(const std::vector<LineSegment> &segments) : m_segments(segments) {
+    if (segments.empty()) {
+        m_offsets.assign(2, 0);
+        return;
+    }
+
+    float left = segments[0].a.x;
+    float bottom = segments[0].a.y;
+    float right = left;
+    float top = bottom;
+    for (const LineSegment &segment : segments) {
+        left = std::min({left, segment.a.x, segment.b.x});
+        bottom = std::min({bottom, segment.a.y, segment.b.y});
+        right = std::max({right, segment.a.x, segment.b.x});
+        top = std::max({top, segment.a.y, segment.b.y});
+    }
+
+    const float width = std::max(right - left, 1.0f);
+    const float height = std::max(top - bottom, 1.0f);
+    m_origin = {left, bottom};
+    m_cellSize = std::max(
+        std::sqrt(width * height / static_cast<float>(segments.size())),
+        std::max(width, height) / static_cast<float>(maxCellsPerSide)
+    );
+    m_columns = std::min(static_cast<uint32_t>(width / m_cellSize) + 1, maxCellsPerSide);
+    m_rows = std::min(static_cast<uint32_t>(height / m_cellSize) + 1, maxCellsPerSide);
+
+    // Count, then place, so every cell's segments end up contiguous.
+    m_offsets.assign(static_cast<size_t>(m_columns) * m_rows + 1, 0);
+    for (const LineSegment &segment : segments) {
+        rasterize(segment, [this](uint32_t cell) { m_offsets[cell + 1]++; });
+    }
+
+    for (size_t i = 1; i < m_offsets.size(); i++) {
+        m_offsets[i] += m_offsets[i - 1];
+    }
+
+    std::vector<uint32_t> cursor(m_offsets.begin(), m_offsets.end() - 1);
+    m_indices.resize(m_offsets.back());
+    for (uint32_t i = 0; i < segments.size(); i++) {
+        rasterize(segments[i], [&](uint32_t cell) { m_indices[cursor[cell]++] = i; });
+    }
+}
+
+void SegmentGrid::query(const Point &center, float radius, std::vector<uint32_t> &indices) const {
+    indices.clear();
+
+    const uint32_t left = column(center.x - radius);
+    const uint32_t bottom = row(center.y - radius);
+    const uint32_t right = column(center.x + radius);
+    const uint32_t top = row(center.y + radius);
+    for (uint32_t y = bottom; y <= top; y++) {
+        const uint32_t first = y * m_columns + left;
+        const uint32_t last = y * m_columns + right;
+        indices.insert(indices.end(), m_indices.begin() + m_offsets[first], m_indices.begin() + m_offsets[last + 1]);
+    }
+
+    // A segment crossing several cells was gathered from each of them.
+    std::sort(indices.begin(), indices.end());
+    indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+
+    const float reach = radius * radius;
+    indices.erase(
+        std::remove_if(
+            indices.begin(), indices.end(),
+            [&](uint32_t index) { return squaredDistance(center, m_segments[index]) > reach; }
+        ), indices.end()
+    );
+}
+
+const std::vector<LineSegment> &SegmentGrid::segments() const {
+    return m_segments;
+}
+
+float SegmentGrid::cellSize() const {
+    return m_cellSize;
+}
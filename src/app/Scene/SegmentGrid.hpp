@@ -0,0 +1,47 @@
+#pragma once
+
+#include "pch.hpp"
+#include "Math/Geometrics.hpp"
+
+
+/* ****** Segment Grid ******
+* A uniform grid over a level's segments, for finding the ones near a point without visiting the rest.
+*
+* Each segment is listed in every cell it passes through. Cells are stored back to back,
+*   with offsets marking where each one starts, so a query only touches the cells it overlaps
+*   and the cost follows local density rather than the size of the level.
+*
+* Built once and only read afterwards, so any number of threads may query it at the same time.
+*/
+class SegmentGrid {
+    // The segments must not change while the grid is alive.
+    const std::vector<LineSegment> &m_segments;
+
+    Point m_origin;
+    float m_cellSize = 1.0f;
+    uint32_t m_columns = 1;
+    uint32_t m_rows = 1;
+
+    // Cell i holds m_indices[m_offsets[i]] up to m_indices[m_offsets[i + 1]].
+    std::vector<uint32_t> m_offsets;
+    std::vector<uint32_t> m_indices;
+
+    [[nodiscard]] uint32_t column(float x) const;
+
+    [[nodiscard]] uint32_t row(float y) const;
+
+    // Calls visit with the index of every cell the segment passes through, row by row.
+    template<typename Visit>
+    void rasterize(const LineSegment &segment, Visit &&visit) const;
+
+public:
+    // Sizes cells so there are about as many cells as segments.
+    explicit SegmentGrid(const std::vector<LineSegment> &segments);
+
+    // Replaces indices with those of the segments that pass within radius of center, in ascending order.
+    void query(const Point &center, float radius, std::vector<uint32_t> &indices) const;
+
+    [[nodiscard]] const std::vector<LineSegment> &segments() const;
+
+    [[nodiscard]] float cellSize() const;
+};
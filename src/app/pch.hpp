@@ -3,18 +3,31 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
+#include <atomic>
 #include <cassert>
 #include <chrono>
 #include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <memory>
+#include <new>
 #include <algorithm>
 #include <exception>
+#include <functional>
+#include <type_traits>
 #include <variant>
 #include <string>
+#include <string_view>
 #include <fstream>
+#include <iomanip>
+#include <limits>
 #include <sstream>
 #include <vector>
 #include <array>
 #include <unordered_map>
 #include <iostream>
 #include <optional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "pch.hpp"
+#include "State.hpp"
 
 namespace lwvl {
     namespace details {
@@ -24,12 +25,20 @@ namespace lwvl {
         class ID {
             static unsigned int reserve() {
                 unsigned int tempID;
+#if LWVL_HAS_DSA
+                // Named buffer functions need an object, not just a name.
+                if (directStateAccess()) {
+                    glCreateBuffers(1, &tempID);
+                    return tempID;
+                }
+#endif
                 glGenBuffers(1, &tempID);
                 return tempID;
             }
 
         public:
             ~ID() {
+                details::StateCache::current().forgetBuffer(bufferID);
                 glDeleteBuffers(1, &bufferID);
             }
 
@@ -47,6 +56,35 @@ namespace lwvl {
         uint32_t m_id = static_cast<uint32_t>(*m_offsite_id);
         Usage m_usage = Usage::Dynamic;
 
+        // Bind the buffer somewhere it can be edited without disturbing the vertex array or draw bindings.
+        void bindForEdit() {
+            if (details::StateCache::current().buffer(GL_COPY_WRITE_BUFFER, m_id)) {
+                glBindBuffer(GL_COPY_WRITE_BUFFER, m_id);
+            }
+        }
+
+        void allocate(GLsizeiptr size, const void *data) {
+#if LWVL_HAS_DSA
+            if (directStateAccess()) {
+                glNamedBufferData(m_id, size, data, static_cast<GLenum>(m_usage));
+                return;
+            }
+#endif
+            bindForEdit();
+            glBufferData(GL_COPY_WRITE_BUFFER, size, data, static_cast<GLenum>(m_usage));
+        }
+
+        void write(GLintptr offset, GLsizeiptr size, const void *data) {
+#if LWVL_HAS_DSA
+            if (directStateAccess()) {
+                glNamedBufferSubData(m_id, offset, size, data);
+                return;
+            }
+#endif
+            bindForEdit();
+            glBufferSubData(GL_COPY_WRITE_BUFFER, offset, size, data);
+        }
+
     public:
         uint32_t id() {
             return m_id;
@@ -64,31 +102,25 @@ namespace lwvl {
 
         Buffer &operator=(Buffer &&other) noexcept = default;
 
+        // The construct and update functions do not require the buffer to be bound.
         template<typename T>
         void construct(const T *data, GLsizei count) {
-            glBufferData(
-                static_cast<GLenum>(target), sizeof(T) * count,
-                data, static_cast<GLenum>(m_usage)
-            );
+            allocate(sizeof(T) * count, data);
         }
 
         template<class Iterator>
         void construct(Iterator first, Iterator last) {
-            glBufferData(
-                static_cast<GLenum>(target), sizeof(*first) * (last - first),
-                &(*first), static_cast<GLenum>(m_usage)
-            );
+            allocate(sizeof(*first) * (last - first), &(*first));
         }
 
         template<typename T>
         void update(const T *data, GLsizei count, GLsizei offsetCount = 0) {
-            glBufferSubData(static_cast<GLenum>(target), offsetCount * sizeof(T), count * sizeof(T), data);
+            write(offsetCount * sizeof(T), count * sizeof(T), data);
         }
 
         template<class Iterator>
         void update(Iterator first, Iterator last, GLsizei offsetCount = 0) {
-            glBufferSubData(
-                static_cast<GLenum>(target), offsetCount * sizeof(*first), sizeof(*first) * (last - first), &(*first));
+            write(offsetCount * sizeof(*first), sizeof(*first) * (last - first), &(*first));
         }
 
         void usage(Usage usage) { m_usage = usage; }
@@ -97,14 +129,15 @@ namespace lwvl {
 
         // These operations should not be const because they modify GL state.
         void bind() {
-            glBindBuffer(
-                static_cast<GLenum>(target),
-                m_id
-            );
+            if (details::StateCache::current().buffer(static_cast<GLenum>(target), m_id)) {
+                glBindBuffer(static_cast<GLenum>(target), m_id);
+            }
         }
 
         static void clear() {
-            glBindBuffer(static_cast<GLenum>(target), 0);
+            if (details::StateCache::current().buffer(static_cast<GLenum>(target), 0)) {
+                glBindBuffer(static_cast<GLenum>(target), 0);
+            }
         }
     };
 
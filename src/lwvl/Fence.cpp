@@ -0,0 +1,32 @@
+#include "pch.hpp"
+#include "Fence.hpp"
+
+lwvl::Fence::~Fence() {
+    // Deleting a null sync is silently ignored.
+    glDeleteSync(m_sync);
+}
+
+void lwvl::Fence::place() {
+    glDeleteSync(m_sync);
+    m_sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+bool lwvl::Fence::wait(uint64_t timeoutNanoseconds) {
+    if (m_sync == nullptr) {
+        return true;
+    }
+
+    // Flush so the fence is guaranteed to reach the GPU, otherwise the wait could never return.
+    const GLenum result = glClientWaitSync(m_sync, GL_SYNC_FLUSH_COMMANDS_BIT, timeoutNanoseconds);
+    if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED) {
+        glDeleteSync(m_sync);
+        m_sync = nullptr;
+        return true;
+    }
+
+    return false;
+}
+
+bool lwvl::Fence::placed() const {
+    return m_sync != nullptr;
+}
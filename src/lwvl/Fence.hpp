@@ -0,0 +1,34 @@
+#pragma once
+
+#include "pch.hpp"
+
+namespace lwvl {
+    /* ****** Fence ******
+    * Marks a point in the command stream that the CPU can wait on.
+    *
+    * Usage:
+    *   fence.place();      // After the commands to wait for.
+    *   ...
+    *   fence.wait(16000000);  // Blocks until they finish or 16ms pass.
+    */
+    class Fence {
+        GLsync m_sync = nullptr;
+
+    public:
+        Fence() = default;
+
+        Fence(const Fence &other) = delete;
+
+        Fence &operator=(const Fence &other) = delete;
+
+        ~Fence();
+
+        // Replace any previous fence with one after every command issued so far.
+        void place();
+
+        // Returns true if the fence was signaled, or if there is no fence to wait on.
+        bool wait(uint64_t timeoutNanoseconds);
+
+        [[nodiscard]] bool placed() const;
+    };
+}
@@ -2,20 +2,36 @@
 #include "Framebuffer.hpp"
 
 lwvl::Framebuffer::Framebuffer() {
+#if LWVL_HAS_DSA
+    if (directStateAccess()) {
+        glCreateFramebuffers(1, &m_id);
+        return;
+    }
+#endif
     glGenFramebuffers(1, &m_id);
 }
 
 lwvl::Framebuffer::~Framebuffer() {
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    clear();
+    details::StateCache::current().forgetFramebuffer(m_id);
     glDeleteFramebuffers(1, &m_id);
     m_id = 0;
 }
 
 void lwvl::Framebuffer::bind() {
-    glBindFramebuffer(GL_FRAMEBUFFER, m_id);
+    if (details::StateCache::current().framebuffer(m_id)) {
+        glBindFramebuffer(GL_FRAMEBUFFER, m_id);
+    }
 }
 
 void lwvl::Framebuffer::attach(lwvl::Attachment point, lwvl::Texture2D &texture) {
+#if LWVL_HAS_DSA
+    if (directStateAccess()) {
+        glNamedFramebufferTexture(m_id, static_cast<GLenum>(point), texture.m_id, 0);
+        return;
+    }
+#endif
+    bind();
     glFramebufferTexture2D(
         GL_FRAMEBUFFER, static_cast<GLenum>(point),
         GL_TEXTURE_2D, texture.m_id, 0
@@ -23,5 +39,7 @@ void lwvl::Framebuffer::attach(lwvl::Attachment point, lwvl::Texture2D &texture)
 }
 
 void lwvl::Framebuffer::clear() {
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (details::StateCache::current().framebuffer(0)) {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
 }
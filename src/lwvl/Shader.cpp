@@ -3,48 +3,54 @@
 
 
 /* ****** Uniform ****** */
-lwvl::Uniform::Uniform(int location) : m_location(location) {}
+lwvl::Uniform::Uniform(uint32_t program, int location) : m_program(program), m_location(location) {}
 
-void lwvl::Uniform::set1i(const int v0) { glUniform1i(m_location, v0); }
+void lwvl::Uniform::set1i(const int v0) { glProgramUniform1i(m_program, m_location, v0); }
 
-void lwvl::Uniform::set1f(const float v0) { glUniform1f(m_location, v0); }
+void lwvl::Uniform::set1f(const float v0) { glProgramUniform1f(m_program, m_location, v0); }
 
-void lwvl::Uniform::set1u(const unsigned int v0) { glUniform1ui(m_location, v0); }
+void lwvl::Uniform::set1u(const unsigned int v0) { glProgramUniform1ui(m_program, m_location, v0); }
 
-void lwvl::Uniform::set2i(const int v0, const int v1) { glUniform2i(m_location, v0, v1); }
+void lwvl::Uniform::set2i(const int v0, const int v1) { glProgramUniform2i(m_program, m_location, v0, v1); }
 
-void lwvl::Uniform::set2f(const float v0, const float v1) { glUniform2f(m_location, v0, v1); }
+void lwvl::Uniform::set2f(const float v0, const float v1) { glProgramUniform2f(m_program, m_location, v0, v1); }
 
-void lwvl::Uniform::set2u(const unsigned int v0, const unsigned int v1) { glUniform2ui(m_location, v0, v1); }
+void lwvl::Uniform::set2u(const unsigned int v0, const unsigned int v1) {
+    glProgramUniform2ui(m_program, m_location, v0, v1);
+}
 
-void lwvl::Uniform::set3i(const int v0, const int v1, const int v2) { glUniform3i(m_location, v0, v1, v2); }
+void lwvl::Uniform::set3i(const int v0, const int v1, const int v2) {
+    glProgramUniform3i(m_program, m_location, v0, v1, v2);
+}
 
-void lwvl::Uniform::set3f(const float v0, const float v1, const float v2) { glUniform3f(m_location, v0, v1, v2); }
+void lwvl::Uniform::set3f(const float v0, const float v1, const float v2) {
+    glProgramUniform3f(m_program, m_location, v0, v1, v2);
+}
 
 void lwvl::Uniform::set3u(const unsigned int v0, const unsigned int v1, const unsigned int v2) {
-    glUniform3ui(
-        m_location, v0, v1, v2
+    glProgramUniform3ui(
+        m_program, m_location, v0, v1, v2
     );
 }
 
 void lwvl::Uniform::set4i(const int v0, const int v1, const int v2, const int v3) {
-    glUniform4i(
-        m_location, v0, v1, v2, v3
+    glProgramUniform4i(
+        m_program, m_location, v0, v1, v2, v3
     );
 }
 
 void lwvl::Uniform::set4f(const float v0, const float v1, const float v2, const float v3) {
-    glUniform4f(
-        m_location, v0, v1, v2, v3
+    glProgramUniform4f(
+        m_program, m_location, v0, v1, v2, v3
     );
 }
 
 void lwvl::Uniform::set4u(
     const unsigned int v0, const unsigned int v1, const unsigned int v2, const unsigned int v3
-) { glUniform4ui(m_location, v0, v1, v2, v3); }
+) { glProgramUniform4ui(m_program, m_location, v0, v1, v2, v3); }
 
 void lwvl::Uniform::setMatrix4(const float *data) {
-    glUniformMatrix4fv(m_location, 1, GL_FALSE, data);
+    glProgramUniformMatrix4fv(m_program, m_location, 1, GL_FALSE, data);
 }
 
 void lwvl::Uniform::setOrthographic(float top, float bottom, float right, float left, float far, float near) {
@@ -61,7 +67,7 @@ void lwvl::Uniform::setOrthographic(float top, float bottom, float right, float
         1.0f
     };
 
-    glUniformMatrix4fv(m_location, 1, GL_FALSE, ortho);
+    glProgramUniformMatrix4fv(m_program, m_location, 1, GL_FALSE, ortho);
 }
 
 void lwvl::Uniform::set2DOrthographic(float top, float bottom, float right, float left) {
@@ -76,7 +82,7 @@ void lwvl::Uniform::set2DOrthographic(float top, float bottom, float right, floa
         -(right + left) * rlStein, -(top + bottom) * tbStein, 0.0f, 1.0f
     };
 
-    glUniformMatrix4fv(m_location, 1, GL_FALSE, ortho);
+    glProgramUniformMatrix4fv(m_program, m_location, 1, GL_FALSE, ortho);
 }
 
 int lwvl::Uniform::location() const {
@@ -102,7 +108,7 @@ unsigned int lwvl::ShaderProgram::id() const {
 
 lwvl::Uniform lwvl::ShaderProgram::uniform(const std::string &name) {
     int location = uniformLocation(name);
-    return Uniform(location);
+    return Uniform(m_id, location);
 }
 
 void lwvl::ShaderProgram::link() {
@@ -155,9 +161,13 @@ void lwvl::ShaderProgram::link(const std::string &vertexSource, const std::strin
 }
 
 void lwvl::ShaderProgram::bind() const {
-    glUseProgram(m_id);
+    if (details::StateCache::current().program(m_id)) {
+        glUseProgram(m_id);
+    }
 }
 
 void lwvl::ShaderProgram::clear() {
-    glUseProgram(0);
+    if (details::StateCache::current().program(0)) {
+        glUseProgram(0);
+    }
 }
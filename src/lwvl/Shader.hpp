@@ -1,15 +1,18 @@
 #pragma once
 
 #include "pch.hpp"
+#include "State.hpp"
 
 namespace lwvl {
+    // Uniforms are set with glProgramUniform, so the program does not need to be bound to set them.
     class Uniform {
+        uint32_t m_program = 0;
         int m_location = -1;
 
     public:
         Uniform() = default;
 
-        explicit Uniform(int location);
+        Uniform(uint32_t program, int location);
 
         Uniform(const Uniform &other) = default;
 
@@ -172,6 +175,7 @@ namespace lwvl {
 
         public:
             ~ID() {
+                details::StateCache::current().forgetProgram(programID);
                 glDeleteProgram(programID);
             }
 
@@ -0,0 +1,159 @@
+#include "pch.hpp"
+#include "State.hpp"
+
+
+/* ****** State Cache ****** */
+lwvl::details::StateCache::StateCache() {
+    m_buffers.fill(unknown);
+    m_textures.fill(unknown);
+}
+
+void lwvl::details::StateCache::init() {
+    invalidate();
+    dsa(true);
+}
+
+lwvl::details::StateCache &lwvl::details::StateCache::current() {
+    thread_local StateCache cache;
+    return cache;
+}
+
+bool lwvl::details::StateCache::exchange(uint32_t &slot, uint32_t id) {
+    if (slot == id) {
+        m_counters.skipped++;
+        return false;
+    }
+
+    slot = id;
+    m_counters.issued++;
+    return true;
+}
+
+size_t lwvl::details::StateCache::bufferSlot(GLenum target) {
+    switch (target) {
+        case GL_ARRAY_BUFFER: return 0;
+        case GL_ELEMENT_ARRAY_BUFFER: return 1;
+        case GL_TEXTURE_BUFFER: return 2;
+        case GL_UNIFORM_BUFFER: return 3;
+        case GL_SHADER_STORAGE_BUFFER: return 4;
+        default: return 5;  // GL_COPY_WRITE_BUFFER, used for bind-to-edit uploads.
+    }
+}
+
+bool lwvl::details::StateCache::program(uint32_t id) {
+    return exchange(m_program, id);
+}
+
+bool lwvl::details::StateCache::vertexArray(uint32_t id) {
+    const bool changed = exchange(m_vertexArray, id);
+
+    // The element buffer binding is part of the vertex array's state.
+    if (changed) {
+        m_buffers[bufferSlot(GL_ELEMENT_ARRAY_BUFFER)] = unknown;
+    }
+
+    return changed;
+}
+
+bool lwvl::details::StateCache::buffer(GLenum target, uint32_t id) {
+    return exchange(m_buffers[bufferSlot(target)], id);
+}
+
+bool lwvl::details::StateCache::framebuffer(uint32_t id) {
+    return exchange(m_framebuffer, id);
+}
+
+bool lwvl::details::StateCache::activeUnit(uint32_t unit) {
+    return exchange(m_activeUnit, unit);
+}
+
+bool lwvl::details::StateCache::texture(uint32_t unit, uint32_t id) {
+    if (unit >= textureUnits) {
+        m_counters.issued++;
+        return true;
+    }
+
+    return exchange(m_textures[unit], id);
+}
+
+void lwvl::details::StateCache::forgetProgram(uint32_t id) {
+    if (m_program == id) { m_program = unknown; }
+}
+
+void lwvl::details::StateCache::forgetVertexArray(uint32_t id) {
+    if (m_vertexArray == id) {
+        m_vertexArray = unknown;
+        m_buffers[bufferSlot(GL_ELEMENT_ARRAY_BUFFER)] = unknown;
+    }
+}
+
+void lwvl::details::StateCache::forgetBuffer(uint32_t id) {
+    for (uint32_t &binding : m_buffers) {
+        if (binding == id) { binding = unknown; }
+    }
+}
+
+void lwvl::details::StateCache::forgetFramebuffer(uint32_t id) {
+    if (m_framebuffer == id) { m_framebuffer = unknown; }
+}
+
+void lwvl::details::StateCache::forgetTexture(uint32_t id) {
+    for (uint32_t &binding : m_textures) {
+        if (binding == id) { binding = unknown; }
+    }
+}
+
+void lwvl::details::StateCache::invalidate() {
+    m_program = unknown;
+    m_vertexArray = unknown;
+    m_framebuffer = unknown;
+    m_activeUnit = unknown;
+    m_buffers.fill(unknown);
+    m_textures.fill(unknown);
+}
+
+bool lwvl::details::StateCache::dsa() const {
+    return m_dsa;
+}
+
+void lwvl::details::StateCache::dsa(bool enabled) {
+#if LWVL_HAS_DSA
+    m_dsa = enabled && GLAD_GL_VERSION_4_5 != 0;
+#else
+    m_dsa = false;
+#endif
+}
+
+const lwvl::StateCounters &lwvl::details::StateCache::counters() const {
+    return m_counters;
+}
+
+void lwvl::details::StateCache::resetCounters() {
+    m_counters = StateCounters();
+}
+
+
+/* ****** Free Functions ****** */
+void lwvl::initState() {
+    details::StateCache::current().init();
+}
+
+bool lwvl::directStateAccess() {
+    return details::StateCache::current().dsa();
+}
+
+void lwvl::directStateAccess(bool enabled) {
+    details::StateCache::current().dsa(enabled);
+}
+
+lwvl::StateCounters lwvl::stateCounters() {
+    return details::StateCache::current().counters();
+}
+
+void lwvl::resetStateCounters() {
+    details::StateCache::current().resetCounters();
+}
+
+void lwvl::invalidateState() {
+    details::StateCache::current().invalidate();
+}
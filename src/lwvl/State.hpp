@@ -0,0 +1,108 @@
+#pragma once
+
+#include "pch.hpp"
+
+// Direct state access is core in 4.5. The context is created as 4.3, so the
+//   entry points are only used when the loader found them at runtime.
+#if defined(GL_VERSION_4_5)
+#define LWVL_HAS_DSA 1
+#else
+#define LWVL_HAS_DSA 0
+#endif
+
+namespace lwvl {
+    struct StateCounters {
+        // Calls that reached the driver.
+        uint64_t issued = 0;
+
+        // Calls that were skipped because the object was already bound.
+        uint64_t skipped = 0;
+    };
+
+    namespace details {
+        /* ****** State Cache ******
+        * Shadows the bindings of the current context so redundant binds can be skipped.
+        * A context is only ever current on one thread, so there is one cache per thread.
+        *
+        * Every bind function returns true when the caller must issue the GL call.
+        */
+        class StateCache {
+            static constexpr uint32_t unknown = ~0u;
+            static constexpr size_t textureUnits = 32;
+            static constexpr size_t bufferTargets = 6;
+
+            uint32_t m_program = unknown;
+            uint32_t m_vertexArray = unknown;
+            uint32_t m_framebuffer = unknown;
+            uint32_t m_activeUnit = unknown;
+            std::array<uint32_t, bufferTargets> m_buffers{};
+            std::array<uint32_t, textureUnits> m_textures{};
+            bool m_dsa = false;
+
+            StateCounters m_counters;
+
+            bool exchange(uint32_t &slot, uint32_t id);
+
+            static size_t bufferSlot(GLenum target);
+
+        public:
+            StateCache();
+
+            static StateCache &current();
+
+            // Forget the bindings and detect direct state access. The loader must have run for the current context.
+            void init();
+
+            bool program(uint32_t id);
+
+            bool vertexArray(uint32_t id);
+
+            bool buffer(GLenum target, uint32_t id);
+
+            bool framebuffer(uint32_t id);
+
+            bool activeUnit(uint32_t unit);
+
+            bool texture(uint32_t unit, uint32_t id);
+
+            // Objects that are deleted are unbound by GL, so their names must not stay cached.
+            void forgetProgram(uint32_t id);
+
+            void forgetVertexArray(uint32_t id);
+
+            void forgetBuffer(uint32_t id);
+
+            void forgetFramebuffer(uint32_t id);
+
+            void forgetTexture(uint32_t id);
+
+            // Forget everything. Use after code outside of lwvl has touched bindings.
+            void invalidate();
+
+            [[nodiscard]] bool dsa() const;
+
+            void dsa(bool enabled);
+
+            [[nodiscard]] const StateCounters &counters() const;
+
+            void resetCounters();
+        };
+    }
+
+    // Call on the context's thread once it is current and the loader has run. Until then direct state access is
+    //   off, since the loader has not yet said whether the context supports it.
+    void initState();
+
+    // True when the direct state access path is in use for the current context.
+    bool directStateAccess();
+
+    // Toggle the direct state access path. Requests to enable it are ignored when it is unsupported.
+    // Objects are created differently on each path, so only toggle this before any are created.
+    void directStateAccess(bool enabled);
+
+    StateCounters stateCounters();
+
+    void resetStateCounters();
+
+    void invalidateState();
+}
@@ -7,6 +7,7 @@ void lwvl::Texture2D::construct(
     lwvl::ChannelLayout internalFormat, lwvl::ChannelOrder format,
     lwvl::ByteFormat type
 ) {
+    bindForEdit();
     glTexImage2D(
         GL_TEXTURE_2D, 0, static_cast<GLint>(internalFormat), width, height, 0,
         static_cast<GLenum>(format), static_cast<GLenum>(type), pixels
@@ -18,6 +19,7 @@ void lwvl::Texture3D::construct(
     lwvl::ChannelLayout internalFormat, lwvl::ChannelOrder format,
     lwvl::ByteFormat type
 ) {
+    bindForEdit();
     glTexImage3D(
         GL_TEXTURE_3D, 0, static_cast<GLenum>(internalFormat),
         width, height, depth, 0, static_cast<GLenum>(format),
@@ -26,5 +28,12 @@ void lwvl::Texture3D::construct(
 }
 
 void lwvl::BufferTexture::construct(lwvl::TextureBuffer &buffer, lwvl::ChannelLayout internalFormat) {
+#if LWVL_HAS_DSA
+    if (directStateAccess()) {
+        glTextureBuffer(m_id, static_cast<GLenum>(internalFormat), buffer.id());
+        return;
+    }
+#endif
+    bindForEdit();
     glTexBuffer(GL_TEXTURE_BUFFER, static_cast<GLenum>(internalFormat), buffer.id());
 }
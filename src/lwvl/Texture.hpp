@@ -4,6 +4,7 @@
 #include "Framebuffer.hpp"
 #include "Buffer.hpp"
 #include "Common.hpp"
+#include "State.hpp"
 
 namespace lwvl {
     class Framebuffer;
@@ -91,14 +92,24 @@ namespace lwvl {
     namespace detail {
         class TextureID {
         protected:
-            static unsigned int reserve() {
+            static unsigned int reserve(GLenum target) {
                 unsigned int tempID;
+#if LWVL_HAS_DSA
+                // Named texture functions need an object, not just a name.
+                if (directStateAccess()) {
+                    glCreateTextures(target, 1, &tempID);
+                    return tempID;
+                }
+#endif
                 glGenTextures(1, &tempID);
                 return tempID;
             }
 
         public:
+            explicit TextureID(GLenum target) : textureID(reserve(target)) {}
+
             ~TextureID() {
+                details::StateCache::current().forgetTexture(textureID);
                 glDeleteTextures(1, &textureID);
             }
 
@@ -106,7 +117,7 @@ namespace lwvl {
                 return textureID;
             }
 
-            const uint32_t textureID = reserve();
+            const uint32_t textureID;
         };
 
         enum class TextureTarget {
@@ -119,14 +130,31 @@ namespace lwvl {
         class TextureBase {
         protected:
             // Offsite Data - to avoid copying buffers on the GPU for shallow copies of this class.
-            std::shared_ptr<TextureID> m_offsite_id = std::make_shared<TextureID>();
+            std::shared_ptr<TextureID> m_offsite_id = std::make_shared<TextureID>(static_cast<GLenum>(target));
 
             // Local Data
             uint32_t m_id = static_cast<uint32_t>(*m_offsite_id);
             uint32_t m_slot = 0;
 
             friend Framebuffer;
+
+            // Bind to the texture's slot through the active texture unit, which glTexImage* calls edit.
+            void bindForEdit() {
+                details::StateCache &state = details::StateCache::current();
+                if (state.activeUnit(m_slot)) {
+                    glActiveTexture(GL_TEXTURE0 + m_slot);
+                }
+
+                if (state.texture(m_slot, m_id)) {
+                    glBindTexture(static_cast<GLenum>(target), m_id);
+                }
+            }
+
         public:
+            [[nodiscard]] uint32_t id() const {
+                return m_id;
+            }
+
             [[nodiscard]] uint32_t slot() const {
                 return m_slot;
             }
@@ -144,8 +172,18 @@ namespace lwvl {
             }
 
             void filter(Filter value) {
-                const auto GLTarget = static_cast<GLenum>(target);
                 const auto GLFilter = static_cast<GLenum>(value);
+#if LWVL_HAS_DSA
+                if (directStateAccess()) {
+                    glTextureParameteri(m_id, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+                    glTextureParameteri(m_id, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+                    glTextureParameteri(m_id, GL_TEXTURE_MIN_FILTER, GLFilter);
+                    glTextureParameteri(m_id, GL_TEXTURE_MAG_FILTER, GLFilter);
+                    return;
+                }
+#endif
+                const auto GLTarget = static_cast<GLenum>(target);
+                bindForEdit();
                 glTexParameteri(GLTarget, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
                 glTexParameteri(GLTarget, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
                 glTexParameteri(GLTarget, GL_TEXTURE_MIN_FILTER, GLFilter);
@@ -153,10 +191,19 @@ namespace lwvl {
             }
 
             void bind() {
-                if (m_id != 0) {
-                    glActiveTexture(GL_TEXTURE0 + m_slot);
-                    glBindTexture(static_cast<GLenum>(target), m_id);
+                if (m_id == 0) {
+                    return;
+                }
+
+#if LWVL_HAS_DSA
+                if (directStateAccess()) {
+                    if (details::StateCache::current().texture(m_slot, m_id)) {
+                        glBindTextureUnit(m_slot, m_id);
+                    }
+                    return;
                 }
+#endif
+                bindForEdit();
             }
         };
     }
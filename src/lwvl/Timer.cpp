@@ -0,0 +1,134 @@
+#include "pch.hpp"
+#include "Timer.hpp"
+
+lwvl::debug::GpuTimer::Scope::Scope(GpuTimer &timer, const char *name) : m_timer(timer) {
+    m_timer.begin(name);
+}
+
+lwvl::debug::GpuTimer::Scope::~Scope() {
+    m_timer.end();
+}
+
+lwvl::debug::GpuTimer::~GpuTimer() {
+    for (Frame &frame : m_frames) {
+        if (!frame.queries.empty()) {
+            glDeleteQueries(static_cast<GLsizei>(frame.queries.size()), frame.queries.data());
+        }
+    }
+}
+
+uint32_t lwvl::debug::GpuTimer::timestamp() {
+    Frame &frame = m_frames[m_current];
+    if (frame.used == frame.queries.size()) {
+        uint32_t query;
+        glGenQueries(1, &query);
+        frame.queries.push_back(query);
+    }
+
+    const uint32_t query = frame.queries[frame.used++];
+    glQueryCounter(query, GL_TIMESTAMP);
+    return query;
+}
+
+size_t lwvl::debug::GpuTimer::pass(const char *name) {
+    for (size_t i = 0; i < m_passes.size(); i++) {
+        if (m_passes[i].name == name) {
+            return i;
+        }
+    }
+
+    m_passes.push_back({name});
+    return m_passes.size() - 1;
+}
+
+void lwvl::debug::GpuTimer::collect(Frame &frame) {
+    if (frame.markers.empty()) {
+        return;
+    }
+
+    // Queries complete in order, so the last one being ready means they all are.
+    GLint available = GL_FALSE;
+    glGetQueryObjectiv(frame.queries[frame.used - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (available == GL_FALSE) {
+        m_dropped++;
+        return;
+    }
+
+    for (const Marker &marker : frame.markers) {
+        GLuint64 begin, end;
+        glGetQueryObjectui64v(marker.begin, GL_QUERY_RESULT, &begin);
+        glGetQueryObjectui64v(marker.end, GL_QUERY_RESULT, &end);
+
+        Pass &pass = m_passes[marker.pass];
+        pass.history[pass.samples++ % window] = static_cast<double>(end - begin) * 0.000001;
+    }
+}
+
+void lwvl::debug::GpuTimer::frame() {
+    m_current = (m_current + 1) % framesInFlight;
+
+    Frame &frame = m_frames[m_current];
+    collect(frame);
+    frame.markers.clear();
+    frame.used = 0;
+}
+
+void lwvl::debug::GpuTimer::begin(const char *name) {
+    Frame &frame = m_frames[m_current];
+    m_open.push_back(frame.markers.size());
+    frame.markers.push_back({pass(name), timestamp(), 0});
+}
+
+void lwvl::debug::GpuTimer::end() {
+    const uint32_t query = timestamp();
+    m_frames[m_current].markers[m_open.back()].end = query;
+    m_open.pop_back();
+}
+
+std::vector<lwvl::debug::GpuPassStats> lwvl::debug::GpuTimer::stats() const {
+    std::vector<GpuPassStats> table;
+    for (const Pass &pass : m_passes) {
+        GpuPassStats stats;
+        stats.name = pass.name;
+        stats.samples = pass.samples;
+
+        const size_t count = std::min<uint64_t>(pass.samples, window);
+        if (count != 0) {
+            stats.last = pass.history[(pass.samples - 1) % window];
+            stats.min = stats.max = stats.last;
+
+            double sum = 0.0;
+            for (size_t i = 0; i < count; i++) {
+                sum += pass.history[i];
+                stats.min = std::min(stats.min, pass.history[i]);
+                stats.max = std::max(stats.max, pass.history[i]);
+            }
+
+            stats.mean = sum / static_cast<double>(count);
+        }
+
+        table.push_back(stats);
+    }
+
+    return table;
+}
+
+uint64_t lwvl::debug::GpuTimer::dropped() const {
+    return m_dropped;
+}
+
+void lwvl::debug::GpuTimer::print(std::ostream &stream) const {
+    stream << "GPU time (ms, last " << window << " frames)\n"
+           << std::left << std::setw(12) << "  pass" << std::right
+           << std::setw(10) << "last" << std::setw(10) << "mean"
+           << std::setw(10) << "min" << std::setw(10) << "max" << '\n';
+
+    for (const GpuPassStats &stats : this->stats()) {
+        stream << "  " << std::left << std::setw(10) << stats.name << std::right << std::fixed << std::setprecision(3)
+               << std::setw(10) << stats.last << std::setw(10) << stats.mean
+               << std::setw(10) << stats.min << std::setw(10) << stats.max << '\n';
+    }
+
+    stream.unsetf(std::ios::fixed);
+    stream << std::setprecision(6) << "  " << m_dropped << " frames dropped waiting for results." << std::endl;
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "pch.hpp"
+
+namespace lwvl::debug {
+    struct GpuPassStats {
+        std::string name;
+
+        // Over the most recent samples, in milliseconds.
+        double last = 0.0;
+        double mean = 0.0;
+        double min = 0.0;
+        double max = 0.0;
+
+        uint64_t samples = 0;
+    };
+
+    /* ****** GPU Timer ******
+    * Times passes on the GPU with timestamp queries.
+    *
+    * Each frame writes its queries into its own slot of a small ring, and a slot is only read back
+    *   when the ring comes around to it again, by which point the GPU has normally finished with it.
+    *   A slot that is still not ready is dropped instead of waited on, so the timer never stalls.
+    *
+    * Usage:
+    *   timer.frame();  // Once per frame, before any scope.
+    *   {
+    *       GpuTimer::Scope scope(timer, "light");
+    *       ...  // Draws to time.
+    *   }
+    *   timer.print(std::cout);
+    */
+    class GpuTimer {
+        static constexpr size_t framesInFlight = 4;
+        static constexpr size_t window = 128;
+
+        struct Marker {
+            size_t pass;
+            uint32_t begin;
+            uint32_t end;
+        };
+
+        struct Frame {
+            std::vector<uint32_t> queries;
+            std::vector<Marker> markers;
+            size_t used = 0;
+        };
+
+        struct Pass {
+            std::string name;
+            std::array<double, window> history{};
+            uint64_t samples = 0;
+        };
+
+        std::array<Frame, framesInFlight> m_frames;
+        size_t m_current = 0;
+
+        std::vector<Pass> m_passes;
+        std::vector<size_t> m_open;
+        uint64_t m_dropped = 0;
+
+        uint32_t timestamp();
+
+        size_t pass(const char *name);
+
+        void collect(Frame &frame);
+
+    public:
+        class Scope {
+            GpuTimer &m_timer;
+
+        public:
+            Scope(GpuTimer &timer, const char *name);
+
+            Scope(const Scope &other) = delete;
+
+            Scope &operator=(const Scope &other) = delete;
+
+            ~Scope();
+        };
+
+        GpuTimer() = default;
+
+        GpuTimer(const GpuTimer &other) = delete;
+
+        GpuTimer &operator=(const GpuTimer &other) = delete;
+
+        ~GpuTimer();
+
+        // Start a new frame, reading back the results of the oldest one if they are ready.
+        void frame();
+
+        // Scopes may nest. Prefer Scope to calling these directly.
+        void begin(const char *name);
+
+        void end();
+
+        [[nodiscard]] std::vector<GpuPassStats> stats() const;
+
+        // Frames whose results were not ready when their slot was reused.
+        [[nodiscard]] uint64_t dropped() const;
+
+        void print(std::ostream &stream) const;
+    };
+}
@@ -2,21 +2,34 @@
 #include "VertexArray.hpp"
 
 lwvl::VertexArray::VertexArray() {
+#if LWVL_HAS_DSA
+    if (directStateAccess()) {
+        glCreateVertexArrays(1, &m_id);
+        return;
+    }
+#endif
     glGenVertexArrays(1, &m_id);
 }
 
 lwvl::VertexArray::~VertexArray() {
+    details::StateCache::current().forgetVertexArray(m_id);
     glDeleteVertexArrays(1, &m_id);
 }
 
 void lwvl::VertexArray::bind() {
-    glBindVertexArray(m_id);
+    if (details::StateCache::current().vertexArray(m_id)) {
+        glBindVertexArray(m_id);
+    }
 }
 
 void lwvl::VertexArray::clear() {
-    glBindVertexArray(0);
+    if (details::StateCache::current().vertexArray(0)) {
+        glBindVertexArray(0);
+    }
 }
 
+uint32_t lwvl::VertexArray::id() const { return m_id; }
+
 uint32_t lwvl::VertexArray::instances() const { return m_instances; }
 
 void lwvl::VertexArray::instances(uint32_t count) { m_instances = count; }
@@ -28,6 +41,37 @@ void lwvl::VertexArray::attribute(uint8_t dimensions, GLenum type, int64_t strid
     m_attributes++;
 }
 
+void lwvl::VertexArray::attribute(
+    ArrayBuffer &buffer, uint8_t dimensions, GLenum type, int64_t stride, int64_t offset, uint32_t divisor
+) {
+#if LWVL_HAS_DSA
+    if (directStateAccess()) {
+        // Each attribute gets a binding point of the same index.
+        const uint32_t index = m_attributes++;
+        glEnableVertexArrayAttrib(m_id, index);
+        glVertexArrayVertexBuffer(m_id, index, buffer.id(), offset, static_cast<GLsizei>(stride));
+        glVertexArrayAttribFormat(m_id, index, dimensions, type, GL_FALSE, 0);
+        glVertexArrayAttribBinding(m_id, index, index);
+        glVertexArrayBindingDivisor(m_id, index, divisor);
+        return;
+    }
+#endif
+    bind();
+    buffer.bind();
+    attribute(dimensions, type, stride, offset, divisor);
+}
+
+void lwvl::VertexArray::elements(ElementBuffer &buffer) {
+#if LWVL_HAS_DSA
+    if (directStateAccess()) {
+        glVertexArrayElementBuffer(m_id, buffer.id());
+        return;
+    }
+#endif
+    bind();
+    buffer.bind();
+}
+
 void lwvl::VertexArray::drawArrays(PrimitiveMode mode, int count) const {
     glDrawArraysInstanced(static_cast<GLenum>(mode), 0, count, m_instances);
 }
@@ -2,6 +2,7 @@
 
 #include "pch.hpp"
 #include "Common.hpp"
+#include "Buffer.hpp"
 
 
 namespace lwvl {
@@ -34,12 +35,24 @@ namespace lwvl {
 
         static void clear();
 
+        [[nodiscard]] uint32_t id() const;
+
         [[nodiscard]] uint32_t instances() const;
 
         void instances(uint32_t count);
 
+        // Describe an attribute sourced from the currently bound array buffer. Requires this array to be bound.
         void attribute(uint8_t dimensions, GLenum type, int64_t stride, int64_t offset, uint32_t divisor = 0);
 
+        // Describe an attribute sourced from buffer. Does not require either object to be bound.
+        void attribute(
+            ArrayBuffer &buffer, uint8_t dimensions, GLenum type,
+            int64_t stride, int64_t offset, uint32_t divisor = 0
+        );
+
+        // Attach the index buffer used by drawElements.
+        void elements(ElementBuffer &buffer);
+
         void drawArrays(PrimitiveMode mode, int count) const;
 
         void drawElements(PrimitiveMode mode, int count, ByteFormat type) const;
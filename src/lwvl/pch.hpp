@@ -1,7 +1,11 @@
 #pragma once
 
 #include <glad/glad.h>
+#include <array>
 #include <fstream>
+#include <iomanip>
+#include <ostream>
 #include <memory>
 #include <sstream>
 #include <string>
+#include <vector>